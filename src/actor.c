@@ -33,14 +33,79 @@ static actor_dispatch_table_t* actor_get_dispatch_table_by_type(actor_type_t typ
 	}
 }
 
+actor_t* actor_pool_alloc(actor_pool_t* pool)
+{
+	if (!pool->free_slots.size) {
+		actor_t* chunk = de_malloc(ACTOR_POOL_CHUNK_SIZE * sizeof(actor_t));
+		DE_ARRAY_APPEND(pool->chunks, chunk);
+		/* reverse order, so slots will be given in order of addresses */
+		for (int i = ACTOR_POOL_CHUNK_SIZE - 1; i >= 0; --i) {
+			DE_ARRAY_APPEND(pool->free_slots, chunk + i);
+		}
+	}
+	actor_t* actor = DE_ARRAY_LAST(pool->free_slots);
+	--pool->free_slots.size;
+	memset(actor, 0, sizeof(*actor));
+	return actor;
+}
+
+bool actor_pool_release(actor_pool_t* pool, actor_t* actor)
+{
+	const uintptr_t address = (uintptr_t)actor;
+	for (size_t i = 0; i < pool->chunks.size; ++i) {
+		const uintptr_t begin = (uintptr_t)pool->chunks.data[i];
+		if (address >= begin && address < begin + ACTOR_POOL_CHUNK_SIZE * sizeof(actor_t)) {
+			DE_ARRAY_APPEND(pool->free_slots, actor);
+			return true;
+		}
+	}
+	return false;
+}
+
+void actor_pool_free(actor_pool_t* pool)
+{
+	for (size_t i = 0; i < pool->chunks.size; ++i) {
+		de_free(pool->chunks.data[i]);
+	}
+	DE_ARRAY_FREE(pool->chunks);
+	DE_ARRAY_FREE(pool->free_slots);
+}
+
+/**
+ * @brief Adds actor to per-type batch of level. Only bots have batch for now,
+ * there is only one player.
+ */
+static void actor_add_to_batch(actor_t* actor)
+{
+	level_t* level = actor->parent_level;
+	if (actor->type == ACTOR_TYPE_BOT) {
+		actor->batch_index = level->bots.size;
+		DE_ARRAY_APPEND(level->bots, actor);
+	}
+}
+
+static void actor_remove_from_batch(actor_t* actor)
+{
+	level_t* level = actor->parent_level;
+	if (actor->type == ACTOR_TYPE_BOT) {
+		DE_ASSERT(level->bots.data[actor->batch_index] == actor);
+		/* swap with last to keep batch packed */
+		actor_t* last = DE_ARRAY_LAST(level->bots);
+		last->batch_index = actor->batch_index;
+		level->bots.data[actor->batch_index] = last;
+		--level->bots.size;
+	}
+}
+
 actor_t* actor_create(level_t* level, actor_type_t type)
 {
-	actor_t* actor = DE_NEW(actor_t);
+	DE_ASSERT(type < ACTOR_TYPE_COUNT);
+	actor_t* actor = actor_pool_alloc(&level->actor_pools[type]);
 	actor->type = type;
 	actor->parent_level = level;
 	actor->dispatch_table = actor_get_dispatch_table_by_type(type);
 	actor->move_speed = 0.028f;
-	actor->health = 100.0f;
+	actor->health = ACTOR_MAX_HEALTH;
 
 	actor->body = de_body_create(level->scene, de_convex_shape_create_capsule(DE_AXIS_Y, 0.2f, 0.5f));
 	de_body_set_gravity(actor->body, &(de_vec3_t) {.y = -20 });
@@ -53,18 +118,25 @@ actor_t* actor_create(level_t* level, actor_type_t type)
 	}
 
 	DE_LINKED_LIST_APPEND(level->actors, actor);
+	actor_add_to_batch(actor);
 
 	return actor;
 }
 
 void actor_free(actor_t* actor)
 {
+	level_t* level = actor->parent_level;
 	if (actor->dispatch_table->deinit) {
 		actor->dispatch_table->deinit(actor);
 	}
 	de_node_free(actor->pivot);
-	DE_LINKED_LIST_REMOVE(actor->parent_level->actors, actor);
-	de_free(actor);
+	DE_LINKED_LIST_REMOVE(level->actors, actor);
+	actor_remove_from_batch(actor);
+	/* every actor comes from pool of its type */
+	DE_ASSERT(actor->type < ACTOR_TYPE_COUNT);
+	const bool released = actor_pool_release(&level->actor_pools[actor->type], actor);
+	DE_ASSERT(released);
+	DE_UNUSED(released);
 }
 
 bool actor_has_ground_contact(actor_t* actor)
@@ -94,26 +166,6 @@ bool actor_process_event(actor_t* actor, const de_event_t* evt)
 	return false;
 }
 
-bool actor_visit(de_object_visitor_t* visitor, actor_t* actor)
-{
-	bool result = true;
-	result &= de_object_visitor_visit_int32(visitor, "Type", (int32_t*)&actor->type);
-	if (visitor->is_reading) {
-		actor->dispatch_table = actor_get_dispatch_table_by_type(actor->type);
-	}
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "Body", &actor->body, de_body_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "Level", &actor->parent_level, level_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "Pivot", &actor->pivot, de_node_visit);
-	result &= de_object_visitor_visit_float(visitor, "MoveSpeed", &actor->move_speed);
-	if (de_object_visitor_enter_node(visitor, "TypeSpecific")) {
-		if (actor->dispatch_table->visit) {
-			result &= actor->dispatch_table->visit(visitor, actor);
-		}
-		de_object_visitor_leave_node(visitor);
-	}
-	return result;
-}
-
 void actor_set_position(actor_t* actor, const de_vec3_t* pos)
 {
 	de_node_set_local_position(actor->pivot, pos);
@@ -121,12 +173,12 @@ void actor_set_position(actor_t* actor, const de_vec3_t* pos)
 
 player_t* actor_to_player(actor_t* actor)
 {
-	return &actor->s.player;
+	return actor->s.player;
 }
 
 actor_t* actor_from_player(player_t* player)
 {
-	return (actor_t*)((char*)player - offsetof(actor_t, s.player));
+	return player->actor;
 }
 
 bot_t* actor_to_bot(actor_t* actor)
@@ -19,35 +19,60 @@
 * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
 * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#define ACTOR_MAX_HEALTH 100.0f
+
 typedef enum actor_type_t {
 	ACTOR_TYPE_PLAYER,
 	ACTOR_TYPE_BOT,
+	ACTOR_TYPE_COUNT,
 	ACTOR_TYPE_FORCE_SIZE = INT32_MAX,
 } actor_type_t;
 
 struct actor_t {
-	actor_type_t type;
-	actor_dispatch_table_t* dispatch_table;
-	level_t* parent_level;
+	/* hot data - touched every tick, keep it at the beginning so it shares cache line */
 	de_body_t* body;
 	de_node_t* pivot;
 	float move_speed;
 	float health;
+	actor_type_t type;
+	level_t* parent_level;
+	/* cold data */
+	actor_dispatch_table_t* dispatch_table;
+	size_t batch_index; /**< Index in per-type batch of level (level->bots for bots) */
 	union {
-		player_t player;
+		player_t* player; /**< Player state is large, it lives in separate block to keep bots compact */
 		bot_t bot;
 	}s;
 	DE_LINKED_LIST_ITEM(actor_t);
 };
 
+#define ACTOR_POOL_CHUNK_SIZE 64
+
+/**
+ * @brief Chunked storage for actors of one type. Actors of same type are placed
+ * next to each other in memory so per-type batch updates walk memory mostly
+ * linearly. Chunks are never moved, so pointers to actors stay valid.
+ */
+typedef struct actor_pool_t {
+	DE_ARRAY_DECLARE(actor_t*, chunks); /**< Each chunk is array of ACTOR_POOL_CHUNK_SIZE actors */
+	DE_ARRAY_DECLARE(actor_t*, free_slots);
+} actor_pool_t;
+
+actor_t* actor_pool_alloc(actor_pool_t* pool);
+
+/**
+ * @brief Returns actor back to pool. Returns false if actor does not belong to pool.
+ */
+bool actor_pool_release(actor_pool_t* pool, actor_t* actor);
+
+void actor_pool_free(actor_pool_t* pool);
+
 actor_t* actor_create(level_t* level, actor_type_t type);
 
 void actor_free(actor_t* actor);
 
 void actor_update(actor_t* actor);
 
-bool actor_visit(de_object_visitor_t* visitor, actor_t* actor);
-
 bool actor_process_event(actor_t* actor, const de_event_t* evt);
 
 void actor_set_position(actor_t* actor, const de_vec3_t* pos);
@@ -0,0 +1,94 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+typedef struct asset_desc_t {
+	de_resource_type_t type;
+	const char* path;
+} asset_desc_t;
+
+static const asset_desc_t asset_descs[ASSET_COUNT] = {
+	[ASSET_MODEL_SOLDIER] = { DE_RESOURCE_TYPE_MODEL, "data/models/soldier/soldier.fbx" },
+	[ASSET_MODEL_AK47] = { DE_RESOURCE_TYPE_MODEL, "data/models/ak47/ak47.fbx" },
+	[ASSET_MODEL_M4] = { DE_RESOURCE_TYPE_MODEL, "data/models/m4/m4.fbx" },
+	[ASSET_MODEL_MEDKIT] = { DE_RESOURCE_TYPE_MODEL, "data/models/medkit.fbx" },
+	[ASSET_MODEL_ROCKET] = { DE_RESOURCE_TYPE_MODEL, "data/models/projectile/rocket.fbx" },
+	[ASSET_MODEL_GRENADE] = { DE_RESOURCE_TYPE_MODEL, "data/models/projectile/grenade.fbx" },
+	[ASSET_MODEL_SPHERE] = { DE_RESOURCE_TYPE_MODEL, "data/models/sphere.fbx" },
+	[ASSET_SOUND_M4_SHOT] = { DE_RESOURCE_TYPE_SOUND_BUFFER, "data/sounds/m4_shot.wav" },
+};
+
+void asset_registry_request(asset_registry_t* registry, de_core_t* core, asset_id_t id)
+{
+	DE_ASSERT(id < ASSET_COUNT);
+	DE_ASSERT(!registry->resources[id]);
+#ifdef SHOOTER_DEDICATED_SERVER
+	/* nothing plays sounds on dedicated server, users of sound assets handle NULL */
+	if (asset_descs[id].type == DE_RESOURCE_TYPE_SOUND_BUFFER) {
+		return;
+	}
+#endif
+	de_path_t path;
+	de_path_from_cstr_as_view(&path, asset_descs[id].path);
+	de_resource_t* res = de_core_request_resource(core, asset_descs[id].type, &path);
+	if (res) {
+		de_resource_add_ref(res);
+	} else {
+		de_log("asset registry: unable to load %s", asset_descs[id].path);
+	}
+	registry->resources[id] = res;
+}
+
+const char* asset_registry_get_path(asset_id_t id)
+{
+	DE_ASSERT(id < ASSET_COUNT);
+	return asset_descs[id].path;
+}
+
+void asset_registry_deinit(asset_registry_t* registry)
+{
+	for (int id = 0; id < ASSET_COUNT; ++id) {
+		if (registry->resources[id]) {
+			de_resource_release(registry->resources[id]);
+			registry->resources[id] = NULL;
+		}
+	}
+}
+
+de_resource_t* asset_registry_get(asset_registry_t* registry, asset_id_t id)
+{
+	DE_ASSERT(id < ASSET_COUNT);
+	++registry->frame_lookups;
+	++registry->total_lookups;
+	return registry->resources[id];
+}
+
+de_model_t* asset_registry_get_model(asset_registry_t* registry, asset_id_t id)
+{
+	de_resource_t* res = asset_registry_get(registry, id);
+	return res ? de_resource_to_model(res) : NULL;
+}
+
+void asset_registry_end_frame(asset_registry_t* registry)
+{
+	registry->last_frame_lookups = registry->frame_lookups;
+	registry->frame_lookups = 0;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+typedef enum asset_id_t {
+	ASSET_MODEL_SOLDIER,
+	ASSET_MODEL_AK47,
+	ASSET_MODEL_M4,
+	ASSET_MODEL_MEDKIT,
+	ASSET_MODEL_ROCKET,
+	ASSET_MODEL_GRENADE,
+	ASSET_MODEL_SPHERE,
+	ASSET_SOUND_M4_SHOT,
+	ASSET_COUNT
+} asset_id_t;
+
+/**
+ * @brief Gameplay assets requested once on level load and held until level is
+ * freed, so spawning and firing take resource by id instead of hashing path
+ * string in resource manager of core.
+ */
+typedef struct asset_registry_t {
+	de_resource_t* resources[ASSET_COUNT]; /**< NULL if resource failed to load. */
+	uint32_t frame_lookups; /**< Lookups since last asset_registry_end_frame. */
+	uint32_t last_frame_lookups; /**< Lookups of previous frame, each one is a saved path lookup. */
+	uint64_t total_lookups; /**< Lookups since level was created, shown on stats overlay. */
+} asset_registry_t;
+
+/**
+ * @brief Requests one asset and adds reference to it, level loader requests every
+ * asset this way, one per step, to spread loading over frames. Registry must be
+ * zeroed before first call.
+ */
+void asset_registry_request(asset_registry_t* registry, de_core_t* core, asset_id_t id);
+
+const char* asset_registry_get_path(asset_id_t id);
+
+/**
+ * @brief Releases references taken by asset_registry_request.
+ */
+void asset_registry_deinit(asset_registry_t* registry);
+
+de_resource_t* asset_registry_get(asset_registry_t* registry, asset_id_t id);
+
+/**
+ * @brief Returns NULL if asset is not loaded.
+ */
+de_model_t* asset_registry_get_model(asset_registry_t* registry, asset_id_t id);
+
+/**
+ * @brief Moves lookup counter of current frame to last_frame_lookups.
+ */
+void asset_registry_end_frame(asset_registry_t* registry);
\ No newline at end of file
@@ -0,0 +1,129 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+static void autosave_swap_buffers(savegame_buffer_t* a, savegame_buffer_t* b)
+{
+	const savegame_buffer_t temp = *a;
+	*a = *b;
+	*b = temp;
+}
+
+static bool autosave_write_file(autosave_t* autosave)
+{
+	FILE* file = fopen(autosave->temp_path, "wb");
+	if (!file) {
+		return false;
+	}
+	bool result = fwrite(autosave->writing.data, 1, autosave->writing.size, file) == autosave->writing.size;
+	result &= fclose(file) == 0;
+	if (result) {
+		/* rename does not overwrite existing file on Windows */
+		remove(autosave->path);
+		result = rename(autosave->temp_path, autosave->path) == 0;
+	}
+	return result;
+}
+
+static int autosave_thread(void* arg)
+{
+	autosave_t* autosave = arg;
+	de_mtx_lock(&autosave->lock);
+	for (;;) {
+		while (autosave->running && !autosave->has_pending) {
+			de_cnd_wait(&autosave->wake, &autosave->lock);
+		}
+		if (!autosave->has_pending) {
+			/* stopped and nothing left to write */
+			break;
+		}
+		autosave_swap_buffers(&autosave->pending, &autosave->writing);
+		autosave->has_pending = false;
+		de_mtx_unlock(&autosave->lock);
+
+		const bool written = autosave_write_file(autosave);
+
+		de_mtx_lock(&autosave->lock);
+		if (written) {
+			++autosave->write_count;
+		} else {
+			de_log("autosave: unable to write %s", autosave->path);
+		}
+	}
+	de_mtx_unlock(&autosave->lock);
+	return 0;
+}
+
+autosave_t* autosave_create(double interval, const char* path, const char* temp_path)
+{
+	autosave_t* autosave = DE_NEW(autosave_t);
+	autosave->interval = interval;
+	autosave->path = path;
+	autosave->temp_path = temp_path;
+	autosave->last_save_time = de_time_get_seconds();
+	autosave->running = true;
+	savegame_buffer_init(&autosave->snapshot);
+	savegame_buffer_init(&autosave->pending);
+	savegame_buffer_init(&autosave->writing);
+	de_mtx_init(&autosave->lock);
+	de_cnd_init(&autosave->wake);
+	de_thread_create(&autosave->thread, autosave_thread, autosave);
+	return autosave;
+}
+
+void autosave_free(autosave_t* autosave)
+{
+	de_mtx_lock(&autosave->lock);
+	autosave->running = false;
+	de_cnd_signal(&autosave->wake);
+	de_mtx_unlock(&autosave->lock);
+	de_thread_join(&autosave->thread);
+
+	de_cnd_destroy(&autosave->wake);
+	de_mtx_destroy(&autosave->lock);
+	savegame_buffer_free(&autosave->snapshot);
+	savegame_buffer_free(&autosave->pending);
+	savegame_buffer_free(&autosave->writing);
+	de_free(autosave);
+}
+
+void autosave_update(autosave_t* autosave, game_t* game)
+{
+	const double now = de_time_get_seconds();
+	if (!game->level || now - autosave->last_save_time < autosave->interval) {
+		return;
+	}
+	autosave->last_save_time = now;
+
+	/* snapshot is taken without lock - writer thread never touches it */
+	savegame_write(game, &autosave->snapshot);
+	autosave->snapshot_time = de_time_get_seconds() - now;
+
+	de_mtx_lock(&autosave->lock);
+	if (autosave->has_pending) {
+		/* writer is so slow that previous snapshot is still waiting, replace it */
+		++autosave->skip_count;
+	}
+	autosave_swap_buffers(&autosave->snapshot, &autosave->pending);
+	autosave->has_pending = true;
+	de_cnd_signal(&autosave->wake);
+	de_mtx_unlock(&autosave->lock);
+}
\ No newline at end of file
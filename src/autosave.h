@@ -0,0 +1,62 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+/**
+ * @brief Periodic save that does not stall frame. Main thread only serializes
+ * state into memory (game-side state only, so it is a few KB), file is written by
+ * background thread. Three buffers are rotated so no buffer is shared while in
+ * use: snapshot (main thread), pending (handed over under lock) and writing
+ * (writer thread).
+ */
+struct autosave_t {
+	de_thread_t thread;
+	de_mtx_t lock;
+	de_cnd_t wake;
+	savegame_buffer_t snapshot;
+	savegame_buffer_t pending;
+	savegame_buffer_t writing;
+	bool has_pending; /**< Protected by lock. */
+	bool running; /**< Protected by lock. */
+	double interval; /**< Seconds between autosaves. */
+	double last_save_time;
+	double snapshot_time; /**< Seconds main thread spent on last snapshot. */
+	size_t write_count; /**< Protected by lock. */
+	size_t skip_count; /**< Snapshots skipped because writer was still busy. */
+	const char* path;
+	const char* temp_path;
+};
+
+/**
+ * @brief Starts writer thread. Files are written to temp_path first and then
+ * renamed to path, so crash in the middle of write never breaks previous save.
+ */
+autosave_t* autosave_create(double interval, const char* path, const char* temp_path);
+
+/**
+ * @brief Waits until last snapshot is written and stops writer thread.
+ */
+void autosave_free(autosave_t* autosave);
+
+/**
+ * @brief Takes snapshot of game if interval has passed. Call from main thread once per tick.
+ */
+void autosave_update(autosave_t* autosave, game_t* game);
\ No newline at end of file
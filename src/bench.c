@@ -0,0 +1,550 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+void bench_stats_init(bench_stats_t* stats, const char* name)
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->name = name;
+	stats->start_time = de_time_get_seconds();
+	stats->start_alloc_count = de_get_alloc_count();
+}
+
+void bench_stats_free(bench_stats_t* stats)
+{
+	DE_ARRAY_FREE(stats->samples);
+}
+
+void bench_stats_add_sample(bench_stats_t* stats, double seconds)
+{
+	DE_ARRAY_APPEND(stats->samples, seconds);
+}
+
+static int bench_compare_samples(const void* a, const void* b)
+{
+	const double da = *(const double*)a;
+	const double db = *(const double*)b;
+	return (da > db) - (da < db);
+}
+
+double bench_stats_percentile(bench_stats_t* stats, double percentile)
+{
+	if (!stats->samples.size) {
+		return 0.0;
+	}
+	qsort(stats->samples.data, stats->samples.size, sizeof(*stats->samples.data), bench_compare_samples);
+	size_t index = (size_t)(percentile / 100.0 * (double)(stats->samples.size - 1) + 0.5);
+	if (index >= stats->samples.size) {
+		index = stats->samples.size - 1;
+	}
+	return stats->samples.data[index];
+}
+
+void bench_stats_report(bench_stats_t* stats)
+{
+	const double total_time = de_time_get_seconds() - stats->start_time;
+	const size_t count = stats->samples.size;
+	/* allocations are measured as difference of engine allocation counter, so
+	 * leaked (or cached) allocations are visible here as well */
+	const double allocs_per_iteration = count ?
+		((double)de_get_alloc_count() - (double)stats->start_alloc_count) / (double)count : 0.0;
+	double sum = 0.0;
+	for (size_t i = 0; i < count; ++i) {
+		sum += stats->samples.data[i];
+	}
+	const double p50 = bench_stats_percentile(stats, 50.0);
+	const double p99 = bench_stats_percentile(stats, 99.0);
+	const double max = count ? DE_ARRAY_LAST(stats->samples) : 0.0;
+
+	char buffer[1024];
+	snprintf(buffer, sizeof(buffer), "bench %s: iterations=%d total=%.3f s per_second=%.1f mean=%.4f ms p50=%.4f ms p99=%.4f ms max=%.4f ms allocs_per_iteration=%.2f",
+		stats->name, (int)count, total_time, sum > 0.0 ? (double)count / sum : 0.0,
+		count ? sum * 1000.0 / (double)count : 0.0, p50 * 1000.0, p99 * 1000.0, max * 1000.0, allocs_per_iteration);
+	printf("%s\n", buffer);
+	de_log("%s", buffer);
+}
+
+/**
+ * @brief Spawns extra bots on a ring around level origin, so benchmark can
+ * scale actor count independently of level content.
+ */
+static void bench_spawn_bots(level_t* level, int count)
+{
+	const float ring_step = 0.75f;
+	const float two_pi = 6.28318530718f;
+	const int bots_per_ring = 16;
+	for (int i = 0; i < count; ++i) {
+		const float radius = 2.0f + ring_step * (float)(i / bots_per_ring);
+		const float angle = two_pi * (float)(i % bots_per_ring) / (float)bots_per_ring;
+		actor_t* bot = actor_create(level, ACTOR_TYPE_BOT);
+		actor_set_position(bot, &(de_vec3_t) { radius * (float)cos(angle), 1.0f, radius * (float)sin(angle) });
+	}
+}
+
+/**
+ * @brief Deterministic random number in [0; 1), so every run of benchmark
+ * gets same input.
+ */
+static float bench_random(uint32_t* seed)
+{
+	*seed = *seed * 1664525u + 1013904223u;
+	return (float)(*seed >> 8) / 16777216.0f;
+}
+
+/**
+ * @brief Reports how long navigation grid took to bake and measures flow field
+ * rebuild and per-bot query cost. Query samples are batches, because single
+ * lookup is way below timer resolution.
+ */
+static void bench_run_navigation(level_t* level)
+{
+	nav_grid_t* nav = level->nav;
+	if (!nav || !nav->cells) {
+		return;
+	}
+	const int queries_per_sample = 1000;
+	const int sample_count = 256;
+	const float extent_x = (float)nav->width * nav->cell_size;
+	const float extent_z = (float)nav->depth * nav->cell_size;
+	/* fixed seed, so every run queries same points */
+	uint32_t seed = 12345;
+
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "bench navigation_bake: cells=%dx%d time=%.3f ms",
+		nav->width, nav->depth, nav->bake_time * 1000.0);
+	printf("%s\n", buffer);
+	de_log("%s", buffer);
+
+	bench_stats_t stats;
+	bench_stats_init(&stats, "navigation_flow_rebuild");
+	for (int i = 0; i < sample_count; ++i) {
+		const size_t rebuild_count = nav->flow_rebuild_count;
+		const float x = nav->origin.x + extent_x * bench_random(&seed);
+		const float z = nav->origin.z + extent_z * bench_random(&seed);
+		const nav_cell_t* cell = nav->cells + (int)((z - nav->origin.z) / nav->cell_size) * nav->width + (int)((x - nav->origin.x) / nav->cell_size);
+		if (cell->layer_count) {
+			nav_grid_set_target(nav, &(de_vec3_t) { x, cell->floor[0] + 0.5f, z });
+			if (nav->flow_rebuild_count != rebuild_count) {
+				bench_stats_add_sample(&stats, nav->flow_time);
+			}
+		}
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+
+	bench_stats_init(&stats, "navigation_query_x1000");
+	size_t hits = 0;
+	for (int i = 0; i < sample_count; ++i) {
+		const double start = de_time_get_seconds();
+		for (int k = 0; k < queries_per_sample; ++k) {
+			const float x = nav->origin.x + extent_x * bench_random(&seed);
+			const float z = nav->origin.z + extent_z * bench_random(&seed);
+			de_vec3_t direction;
+			hits += nav_grid_get_flow(nav, &(de_vec3_t) { x, 0.5f, z }, &direction);
+		}
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+	de_log("bench navigation_query: %d of %d points have flow", (int)hits, sample_count * queries_per_sample);
+}
+
+/**
+ * @brief Checks triangle-square overlap test used to rasterize obstacles into navigation
+ * grid against known cases, broken test makes bots walk through walls.
+ */
+static void bench_check_nav_overlap(void)
+{
+	static const struct {
+		de_vec3_t a, b, c;
+		float min_x, min_z, max_x, max_z;
+		bool overlap;
+	} cases[] = {
+		/* square inside triangle */
+		{ { 0, 0, 0 }, { 10, 0, 0 }, { 0, 0, 10 }, 1, 1, 2, 2, true },
+		/* square straddles hypotenuse */
+		{ { 0, 0, 0 }, { 10, 0, 0 }, { 0, 0, 10 }, 4, 4, 6, 6, true },
+		/* square straddles hypotenuse, triangle has opposite winding */
+		{ { 0, 0, 0 }, { 0, 0, 10 }, { 10, 0, 0 }, 4, 4, 6, 6, true },
+		/* small triangle inside square */
+		{ { 0.2f, 0, 0.2f }, { 0.4f, 0, 0.2f }, { 0.2f, 0, 0.4f }, 0, 0, 1, 1, true },
+		/* square is within bounds of triangle, but beyond hypotenuse */
+		{ { 0, 0, 0 }, { 10, 0, 0 }, { 0, 0, 10 }, 8, 8, 9, 9, false },
+		{ { 0, 0, 0 }, { 0, 0, 10 }, { 10, 0, 0 }, 8, 8, 9, 9, false },
+		/* vertical wall along X projects onto XZ as segment */
+		{ { 0, 0, 5 }, { 10, 0, 5 }, { 0, 3, 5 }, 4, 4.5f, 5, 5.5f, true },
+		{ { 0, 0, 5 }, { 10, 0, 5 }, { 0, 3, 5 }, 4, 6, 5, 7, false },
+		/* diagonal vertical wall, square on it */
+		{ { 0, 0, 0 }, { 10, 3, 10 }, { 0, 3, 0 }, 5, 5, 5.25f, 5.25f, true },
+		{ { 0, 0, 0 }, { 10, 3, 10 }, { 0, 3, 0 }, 4.9f, 5.1f, 5.15f, 5.35f, true },
+		/* diagonal vertical wall, square inside bounds of wall but away from it */
+		{ { 0, 0, 0 }, { 10, 3, 10 }, { 0, 3, 0 }, 8, 1, 8.25f, 1.25f, false },
+		{ { 0, 0, 0 }, { 10, 3, 10 }, { 0, 3, 0 }, 1, 8, 1.25f, 8.25f, false },
+	};
+	int mismatch_count = 0;
+	for (size_t i = 0; i < DE_ARRAY_SIZE(cases); ++i) {
+		const de_static_triangle_t triangle = { .a = cases[i].a, .b = cases[i].b, .c = cases[i].c };
+		const bool overlap = nav_triangle_overlaps_square(&triangle, cases[i].min_x, cases[i].min_z, cases[i].max_x, cases[i].max_z);
+		mismatch_count += overlap != cases[i].overlap;
+	}
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "bench nav_overlap: %s, mismatches=%d of %d cases",
+		mismatch_count ? "FAILED" : "ok", mismatch_count, (int)DE_ARRAY_SIZE(cases));
+	printf("%s\n", buffer);
+	de_log("%s", buffer);
+}
+
+/**
+ * @brief Checks that vector ray-capsule kernel gives bit-identical results with
+ * scalar path on random input (there is no unit test framework, so this runs
+ * with every benchmark), then measures vector, scalar and generic engine routine.
+ */
+static void bench_run_ray_capsule_kernel(void)
+{
+	enum {
+		capsule_count = 4096,
+		ray_count = 256
+	};
+	uint32_t seed = 777;
+	float* data = de_malloc(7 * capsule_count * sizeof(float));
+	float* x = data;
+	float* y = x + capsule_count;
+	float* z = y + capsule_count;
+	float* half_height = z + capsule_count;
+	float* radius = half_height + capsule_count;
+	float* vector_t = radius + capsule_count;
+	float* scalar_t = vector_t + capsule_count;
+	for (int i = 0; i < capsule_count; ++i) {
+		x[i] = bench_random(&seed) * 40.0f - 20.0f;
+		y[i] = bench_random(&seed) * 4.0f - 2.0f;
+		z[i] = bench_random(&seed) * 40.0f - 20.0f;
+		half_height[i] = 0.25f;
+		radius[i] = 0.2f + bench_random(&seed) * 0.05f;
+	}
+	const ray_capsule_soa_t capsules = { x, y, z, half_height, radius, capsule_count };
+	de_ray_t rays[ray_count];
+	for (int i = 0; i < ray_count; ++i) {
+		rays[i].origin = (de_vec3_t) { bench_random(&seed) * 4.0f - 2.0f, bench_random(&seed), bench_random(&seed) * 4.0f - 2.0f };
+		rays[i].dir = (de_vec3_t) { bench_random(&seed) * 60.0f - 30.0f, bench_random(&seed) * 2.0f - 1.0f, bench_random(&seed) * 60.0f - 30.0f };
+	}
+
+	int mismatch_count = 0;
+	int hit_count = 0;
+	for (int i = 0; i < ray_count; ++i) {
+		ray_capsule_intersect_many(rays + i, &capsules, vector_t);
+		ray_capsule_intersect_many_scalar(rays + i, &capsules, scalar_t);
+		for (int k = 0; k < capsule_count; ++k) {
+			mismatch_count += memcmp(vector_t + k, scalar_t + k, sizeof(float)) != 0;
+			hit_count += scalar_t[k] != FLT_MAX;
+		}
+	}
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "bench ray_capsule: %s, mismatches=%d hits=%d of %d tests",
+		mismatch_count ? "FAILED" : "ok", mismatch_count, hit_count, ray_count * capsule_count);
+	printf("%s\n", buffer);
+	de_log("%s", buffer);
+
+	bench_stats_t stats;
+	bench_stats_init(&stats, "ray_capsule_vector_x4096");
+	for (int i = 0; i < ray_count; ++i) {
+		const double start = de_time_get_seconds();
+		ray_capsule_intersect_many(rays + i, &capsules, vector_t);
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+
+	bench_stats_init(&stats, "ray_capsule_scalar_x4096");
+	for (int i = 0; i < ray_count; ++i) {
+		const double start = de_time_get_seconds();
+		ray_capsule_intersect_many_scalar(rays + i, &capsules, scalar_t);
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+
+	bench_stats_init(&stats, "ray_capsule_engine_x4096");
+	for (int i = 0; i < ray_count; ++i) {
+		const double start = de_time_get_seconds();
+		for (int k = 0; k < capsule_count; ++k) {
+			const de_vec3_t pa = { x[k], y[k] - half_height[k], z[k] };
+			const de_vec3_t pb = { x[k], y[k] + half_height[k], z[k] };
+			de_vec3_t points[2];
+			scalar_t[k] = de_ray_capsule_intersection(rays + i, &pa, &pb, radius[k], points) ? 0.0f : FLT_MAX;
+		}
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+
+	de_free(data);
+}
+
+/**
+ * @brief Compares batched hitscan resolve with per-shot sorted scene ray cast
+ * on same set of rays. Rays go from random points near origin towards random
+ * actors, so most of them hit something.
+ */
+static void bench_run_hitscan(level_t* level)
+{
+	const int rays_per_tick = 1000;
+	const int tick_count = 64;
+	const float range = 30.0f;
+	uint32_t seed = 54321;
+
+	DE_ARRAY_DECLARE(actor_t*, actors);
+	DE_ARRAY_INIT(actors);
+	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+		DE_ARRAY_APPEND(actors, actor);
+	}
+	if (!actors.size) {
+		DE_ARRAY_FREE(actors);
+		return;
+	}
+
+	DE_ARRAY_DECLARE(de_ray_t, rays);
+	DE_ARRAY_INIT(rays);
+	for (int i = 0; i < rays_per_tick; ++i) {
+		de_ray_t ray;
+		ray.origin = (de_vec3_t) { bench_random(&seed) * 2.0f - 1.0f, 0.5f, bench_random(&seed) * 2.0f - 1.0f };
+		de_vec3_t target;
+		de_node_get_global_position(actors.data[(size_t)(bench_random(&seed) * (float)actors.size)]->pivot, &target);
+		de_vec3_sub(&ray.dir, &target, &ray.origin);
+		de_vec3_normalize(&ray.dir, &ray.dir);
+		de_vec3_scale(&ray.dir, &ray.dir, range);
+		DE_ARRAY_APPEND(rays, ray);
+	}
+
+	/* no damage, so actors stay same for both runs */
+	size_t batched_hits = 0;
+	bench_stats_t stats;
+	bench_stats_init(&stats, "hitscan_batched_x1000");
+	for (int tick = 0; tick < tick_count; ++tick) {
+		const double start = de_time_get_seconds();
+		for (size_t i = 0; i < rays.size; ++i) {
+			hitscan_queue_shot(&level->hitscan, rays.data + i, 0.0f, NULL);
+		}
+		hitscan_resolve(&level->hitscan, level);
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+		for (size_t i = 0; i < level->hitscan.results.size; ++i) {
+			batched_hits += level->hitscan.results.data[i].actor != NULL;
+		}
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+
+	/* old way: full sorted query against every body and triangle per shot */
+	size_t sorted_hits = 0;
+	de_ray_cast_result_array_t results;
+	DE_ARRAY_INIT(results);
+	bench_stats_init(&stats, "hitscan_sorted_ray_cast_x1000");
+	for (int tick = 0; tick < tick_count; ++tick) {
+		const double start = de_time_get_seconds();
+		for (size_t i = 0; i < rays.size; ++i) {
+			if (de_ray_cast(level->scene, rays.data + i, DE_RAY_CAST_FLAGS_SORT_RESULTS, &results)) {
+				sorted_hits += results.data[0].body != NULL;
+			}
+		}
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+	DE_ARRAY_FREE(results);
+
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "bench hitscan: actor hits batched=%d sorted=%d", (int)batched_hits, (int)sorted_hits);
+	printf("%s\n", buffer);
+	de_log("%s", buffer);
+
+	DE_ARRAY_FREE(rays);
+	DE_ARRAY_FREE(actors);
+}
+
+/**
+ * @brief Compares grid pickup pass with all-pairs actor-item test. Items are
+ * medkits and actors are healed first, so no item is actually picked up and
+ * both passes see same state.
+ */
+static void bench_run_item_pickup(level_t* level)
+{
+	const int item_count = 500;
+	const int tick_count = 256;
+	const float extent = 64.0f;
+	uint32_t seed = 777;
+
+	const size_t first_item = level->items.size;
+	for (int i = 0; i < item_count; ++i) {
+		item_t* item = item_create(level, ITEM_TYPE_MEDKIT);
+		item_set_position(item, &(de_vec3_t) { (bench_random(&seed) - 0.5f) * extent, 0.1f, (bench_random(&seed) - 0.5f) * extent });
+	}
+	size_t actor_count = 0;
+	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+		actor->health = ACTOR_MAX_HEALTH;
+		++actor_count;
+	}
+
+	bench_stats_t stats;
+	bench_stats_init(&stats, "item_pickup_grid");
+	for (int tick = 0; tick < tick_count; ++tick) {
+		const double start = de_time_get_seconds();
+		item_grid_pick_up(level);
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+	const size_t grid_tests = level->item_grid.test_count;
+
+	size_t all_pairs_hits = 0;
+	bench_stats_init(&stats, "item_pickup_all_pairs");
+	for (int tick = 0; tick < tick_count; ++tick) {
+		const double start = de_time_get_seconds();
+		for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+			de_vec3_t position;
+			de_node_get_global_position(actor->pivot, &position);
+			for (size_t i = 0; i < level->items.size; ++i) {
+				const item_t* item = level->items.data[i];
+				const float dx = item->position.x - position.x;
+				const float dz = item->position.z - position.z;
+				all_pairs_hits += dx * dx + dz * dz <= ITEM_PICKUP_RADIUS * ITEM_PICKUP_RADIUS;
+			}
+		}
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "bench item_pickup: %d actors, %d items, tests per tick grid=%d all_pairs=%d (%d in radius)",
+		(int)actor_count, (int)level->items.size, (int)grid_tests, (int)(actor_count * level->items.size), (int)(all_pairs_hits / tick_count));
+	printf("%s\n", buffer);
+	de_log("%s", buffer);
+
+	while (level->items.size > first_item) {
+		item_free(DE_ARRAY_LAST(level->items));
+	}
+}
+
+/**
+ * @brief Measures serialization to memory, save to file and load from file of
+ * populated level. Load replaces game->level, so this must be the last benchmark.
+ */
+static void bench_run_save_load(game_t* game)
+{
+	const int iteration_count = 32;
+	const char* path = "bench_save.bin";
+
+	savegame_buffer_t buffer;
+	savegame_buffer_init(&buffer);
+	bench_stats_t stats;
+	bench_stats_init(&stats, "save_to_memory");
+	for (int i = 0; i < iteration_count; ++i) {
+		const double start = de_time_get_seconds();
+		savegame_write(game, &buffer);
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+	de_log("bench save: %d bytes", (int)buffer.size);
+	printf("bench save: %d bytes\n", (int)buffer.size);
+	savegame_buffer_free(&buffer);
+
+	bench_stats_init(&stats, "save_to_file");
+	for (int i = 0; i < iteration_count; ++i) {
+		const double start = de_time_get_seconds();
+		savegame_save(game, path, NULL);
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+
+	bench_stats_init(&stats, "load_from_file");
+	for (int i = 0; i < iteration_count; ++i) {
+		const double start = de_time_get_seconds();
+		if (!savegame_load(game, path)) {
+			break;
+		}
+		bench_stats_add_sample(&stats, de_time_get_seconds() - start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+	remove(path);
+}
+
+void bench_run_simulation(game_t* game)
+{
+	const game_options_t* options = &game->options;
+	const double fixed_timestep = game->time.delta;
+	replay_t* replay = game->replay && game->replay->mode == REPLAY_MODE_PLAY ? game->replay : NULL;
+	int tick_count = options->bench_ticks;
+
+	if (replay) {
+		/* replay is a fixed regression run: same level, input and tick count as recorded session */
+		if (!game->level) {
+			level_loader_t* loader = level_loader_create(game, replay->map_path, true);
+			level_loader_update(loader, INFINITY);
+			game->level = level_loader_finish(loader);
+		}
+		replay_begin(replay, game->level);
+		tick_count = (int)replay->tick_count;
+	} else if (!game->level) {
+		game->level = level_create_test(game);
+	}
+	level_t* level = game->level;
+
+	if (!replay) {
+		bench_spawn_bots(level, options->bench_bots);
+
+		/* make sure that every actor, pad and collider is in place before measuring */
+		de_scene_update(level->scene, fixed_timestep);
+		de_physics_step(game->core, fixed_timestep);
+	}
+
+	profiler_t* profiler = game->profiler;
+	bench_stats_t stats;
+	bench_stats_init(&stats, "simulation");
+	game->time.seconds = 0.0;
+	printf("bench simulation: tick_rate=%d Hz%s%s\n", (int)game->options.tick_rate, replay ? " replay=" : "", replay ? replay->path : "");
+	for (int i = 0; i < tick_count; ++i) {
+		const double tick_start = de_time_get_seconds();
+		profiler_begin_frame(profiler);
+
+		/* exactly the tick of the game, but with no events, gui, sound or rendering */
+		game_simulate(game);
+
+		profiler_end_frame(profiler);
+		bench_stats_add_sample(&stats, de_time_get_seconds() - tick_start);
+	}
+	bench_stats_report(&stats);
+	bench_stats_free(&stats);
+
+	/* per-subsystem breakdown of last PROFILER_FRAME_HISTORY ticks */
+	char breakdown[2048];
+	profiler_print(profiler, breakdown, sizeof(breakdown));
+	printf("%s", breakdown);
+	de_log("%s", breakdown);
+
+	bench_run_navigation(level);
+	bench_run_ray_capsule_kernel();
+	bench_check_nav_overlap();
+	bench_run_hitscan(level);
+	bench_run_item_pickup(level);
+	bench_run_save_load(game);
+}
\ No newline at end of file
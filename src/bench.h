@@ -0,0 +1,51 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+/**
+ * @brief Collects per-iteration timings of some repeated operation and prints
+ * summary in one format, so CI logs of every headless benchmark look the same.
+ */
+typedef struct bench_stats_t {
+	const char* name;
+	DE_ARRAY_DECLARE(double, samples); /**< Duration of each iteration in seconds. */
+	double start_time;
+	size_t start_alloc_count;
+} bench_stats_t;
+
+void bench_stats_init(bench_stats_t* stats, const char* name);
+
+void bench_stats_free(bench_stats_t* stats);
+
+void bench_stats_add_sample(bench_stats_t* stats, double seconds);
+
+/**
+ * @brief Returns sample at given percentile (0..100) in seconds. Sorts samples.
+ */
+double bench_stats_percentile(bench_stats_t* stats, double percentile);
+
+void bench_stats_report(bench_stats_t* stats);
+
+/**
+ * @brief Runs game simulation (level, scene and physics) for options.bench_ticks fixed
+ * steps as fast as possible, without renderer, gui or sound updates.
+ */
+void bench_run_simulation(game_t* game);
\ No newline at end of file
@@ -23,11 +23,9 @@ static void bot_init(actor_t* actor)
 {
 	actor->move_speed = 0.015f;
 	bot_t* bot = actor_to_bot(actor);
-	de_path_t path;
-	de_path_from_cstr_as_view(&path, "data/models/soldier/soldier.fbx");
-	de_resource_t* soldier_model = de_core_request_resource(actor->parent_level->game->core, DE_RESOURCE_TYPE_MODEL, &path);
+	de_model_t* soldier_model = asset_registry_get_model(&actor->parent_level->assets, ASSET_MODEL_SOLDIER);
 	if (soldier_model) {
-		bot->model = de_model_instantiate(de_resource_to_model(soldier_model), actor->parent_level->scene);
+		bot->model = de_model_instantiate(soldier_model, actor->parent_level->scene);
 		de_node_attach(bot->model, actor->pivot);
 
 		de_capsule_shape_t* capsule_shape = de_convex_shape_to_capsule(de_body_get_shape(actor->body));
@@ -42,50 +40,113 @@ static void bot_deinit(actor_t* actor)
 	DE_UNUSED(actor);
 }
 
-static bool bot_visit(de_object_visitor_t* visitor, actor_t* actor)
-{
-	bool result = true;
-	bot_t* bot = actor_to_bot(actor);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "Model", &bot->model, de_node_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_ENUM(visitor, "Type", &bot->type);
-	return result;
-}
+#define BOT_THINK_GRAIN_SIZE 64
 
-static void bot_update(actor_t* actor)
-{
-//	bot_t* bot = actor_to_bot(actor);
-	const actor_t* player = actor->parent_level->player;
+typedef struct bot_think_context_t {
+	actor_t** bots;
+	bot_command_t* commands;
+	const nav_grid_t* nav;
+	de_vec3_t player_pos;
+} bot_think_context_t;
 
+/**
+ * @brief Must not modify anything - called from worker threads.
+ */
+static void bot_think(const actor_t* actor, const nav_grid_t* nav, const de_vec3_t* player_pos, bot_command_t* command)
+{
 	de_vec3_t self_pos;
 	de_node_get_global_position(actor->pivot, &self_pos);
 
-	de_vec3_t player_pos;
-	de_node_get_global_position(player->pivot, &player_pos);
-
 	de_vec3_t dir;
-	de_vec3_sub(&dir, &player_pos, &self_pos);
+	de_vec3_sub(&dir, player_pos, &self_pos);
 	
 	float distance = 0.0;
 	de_vec3_normalize_ex(&dir, &dir, &distance);
 
-	if (distance > 1.0f) {
-		de_vec3_t velocity;
-		de_vec3_scale(&velocity, &dir, actor->move_speed);
+	command->move = distance > 1.0f;
+	if (command->move) {
+		/* follow flow field around walls, straight line is used only when
+		 * bot is off grid or target is not reachable */
+		de_vec3_t flow;
+		if (nav && nav_grid_get_flow(nav, &self_pos, &flow)) {
+			dir = flow;
+		}
+		de_vec3_scale(&command->velocity, &dir, actor->move_speed);
+	}
 
+	const float angle = -(float)(atan2(dir.z, dir.x) );
+	de_quat_from_axis_angle(&command->rotation, &(de_vec3_t){0, 1, 0}, angle);
+}
+
+static void bot_apply_command(actor_t* actor, const bot_command_t* command)
+{
+	if (command->move) {
 		de_body_set_x_velocity(actor->body, 0.0f);
 		de_body_set_z_velocity(actor->body, 0.0f);
 
+		/* command velocity is per reference tick, scale it to current tick rate */
+		de_vec3_t velocity;
+		de_vec3_scale(&velocity, &command->velocity, game_get_tick_scale(actor->parent_level->game));
 		de_body_move(actor->body, &velocity);
 	}
 
-	de_vec3_t look;
-	de_node_get_look_vector(actor->pivot, &look);
+	de_node_set_local_rotation(actor->pivot, &command->rotation);
+}
 
-	const float angle = -(float)(atan2(dir.z, dir.x) );
-	de_quat_t rotation;
-	de_quat_from_axis_angle(&rotation, &(de_vec3_t){0, 1, 0}, angle);
+static void bot_update(actor_t* actor)
+{
+	de_vec3_t player_pos;
+	de_node_get_global_position(actor->parent_level->player->pivot, &player_pos);
+
+	if (actor->parent_level->nav) {
+		nav_grid_set_target(actor->parent_level->nav, &player_pos);
+	}
+
+	bot_command_t command;
+	bot_think(actor, actor->parent_level->nav, &player_pos, &command);
+	bot_apply_command(actor, &command);
+}
+
+static void bot_think_job(void* user_data, size_t begin, size_t end, int thread_index)
+{
+	bot_think_context_t* ctx = user_data;
+	DE_UNUSED(thread_index);
+	for (size_t i = begin; i < end; ++i) {
+		bot_think(ctx->bots[i], ctx->nav, &ctx->player_pos, ctx->commands + i);
+	}
+}
 
-	de_node_set_local_rotation(actor->pivot, &rotation);
+void bot_update_batch(level_t* level)
+{
+	const size_t count = level->bots.size;
+	if (!level->player || !count) {
+		return;
+	}
+
+	/* one command slot per bot, allocated here so workers never allocate and
+	 * commands are applied in same order regardless of thread count */
+	if (level->bot_command_capacity < count) {
+		level->bot_command_capacity = count * 2;
+		level->bot_commands = de_realloc(level->bot_commands, level->bot_command_capacity * sizeof(*level->bot_commands));
+	}
+
+	bot_think_context_t ctx;
+	ctx.bots = level->bots.data;
+	ctx.commands = level->bot_commands;
+	/* same for every bot, so fetch it once */
+	de_node_get_global_position(level->player->pivot, &ctx.player_pos);
+	/* flow field is rebuilt only when player moves to other cell, and before
+	 * dispatch, so workers only read it */
+	ctx.nav = level->nav;
+	if (level->nav) {
+		nav_grid_set_target(level->nav, &ctx.player_pos);
+	}
+
+	job_system_parallel_for(level->game->jobs, count, BOT_THINK_GRAIN_SIZE, bot_think_job, &ctx);
+
+	for (size_t i = 0; i < count; ++i) {
+		bot_apply_command(ctx.bots[i], ctx.commands + i);
+	}
 }
 
 actor_dispatch_table_t* bot_get_dispatch_table()
@@ -93,7 +154,6 @@ actor_dispatch_table_t* bot_get_dispatch_table()
 	static actor_dispatch_table_t table = {
 		.init = bot_init,
 		.deinit = bot_deinit,
-		.visit = bot_visit,
 		.update = bot_update
 	};
 	return &table;
@@ -29,4 +29,20 @@ struct bot_t {
 	de_node_t* model;
 };
 
-actor_dispatch_table_t* bot_get_dispatch_table();
\ No newline at end of file
+/**
+ * @brief Result of bot thinking. Bots think in parallel against read-only world,
+ * commands are applied on main thread when all bots are done.
+ */
+typedef struct bot_command_t {
+	bool move;
+	de_vec3_t velocity;
+	de_quat_t rotation;
+} bot_command_t;
+
+actor_dispatch_table_t* bot_get_dispatch_table();
+
+/**
+ * @brief Updates every bot of level in one pass over packed level->bots batch.
+ * Thinking runs on job system, results are applied on calling thread.
+ */
+void bot_update_batch(level_t* level);
\ No newline at end of file
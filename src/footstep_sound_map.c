@@ -51,6 +51,50 @@ footstep_sound_group_t* footstep_sound_map_find_or_create_sound_group(footstep_s
 	return &DE_ARRAY_LAST(map->groups);
 }
 
+static footstep_sound_group_t* footstep_sound_map_find_group(footstep_sound_map_t* map, sound_type_t type)
+{
+	for (size_t i = 0; i < map->groups.size; ++i) {
+		footstep_sound_group_t* group = map->groups.data + i;
+		if (group->type == type && group->buffers.size != 0) {
+			return group;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Builds hash table that maps texture hash directly to sound group. Must be
+ * called when groups array will not grow anymore, table stores pointers to groups.
+ */
+static void footstep_sound_map_compile(footstep_sound_map_t* map)
+{
+	/* keep load factor at most 0.5 so probe sequences stay short */
+	map->table_size = 16;
+	while (map->table_size < map->entries.size * 2) {
+		map->table_size *= 2;
+	}
+	map->table = de_calloc(map->table_size, sizeof(*map->table));
+
+	const size_t mask = map->table_size - 1;
+	for (size_t i = 0; i < map->entries.size; ++i) {
+		const footstep_sound_type_map_entry_t* entry = map->entries.data + i;
+		footstep_sound_group_t* group = footstep_sound_map_find_group(map, entry->sound_type);
+		if (!group) {
+			continue;
+		}
+		/* murmur3 hash is already well distributed, so low bits are used as is */
+		size_t index = entry->texture_name_hash & mask;
+		while (map->table[index].group && map->table[index].texture_name_hash != entry->texture_name_hash) {
+			index = (index + 1) & mask;
+		}
+		/* first mapping of texture wins */
+		if (!map->table[index].group) {
+			map->table[index].texture_name_hash = entry->texture_name_hash;
+			map->table[index].group = group;
+		}
+	}
+}
+
 void footstep_sound_map_read(de_core_t* core, footstep_sound_map_t* map)
 {
 	memset(map, 0, sizeof(*map));
@@ -76,6 +120,7 @@ void footstep_sound_map_read(de_core_t* core, footstep_sound_map_t* map)
 			}
 		}
 	}
+	fclose(file);
 
 	/* read sound type to sound buffer list */
 	file = fopen("data/sounds/sound_to_sound_type_map.txt", "r");
@@ -105,6 +150,9 @@ void footstep_sound_map_read(de_core_t* core, footstep_sound_map_t* map)
 			}
 		}
 	}
+	fclose(file);
+
+	footstep_sound_map_compile(map);
 }
 
 void footstep_sound_map_free(footstep_sound_map_t* map)
@@ -121,32 +169,22 @@ void footstep_sound_map_free(footstep_sound_map_t* map)
 
 	/* clean up */
 	DE_ARRAY_FREE(map->entries);
-}
-
-static sound_type_t footstep_sound_map_texture_name_hash_to_sound_type(footstep_sound_map_t* map, uint32_t texture_path_hash)
-{
-	for (size_t i = 0; i < map->entries.size; ++i) {
-		const footstep_sound_type_map_entry_t* entry = map->entries.data + i;
-		if (entry->texture_name_hash == texture_path_hash) {
-			return entry->sound_type;
-		}
+	if (map->table) {
+		de_free(map->table);
 	}
-	return SOUND_TYPE_UNKNOWN;
 }
 
-de_resource_t* footstep_sound_map_probe(footstep_sound_map_t* map, uint32_t texture_path_hash)
+de_resource_t* footstep_sound_map_probe(footstep_sound_map_t* map, uint32_t texture_path_hash, rng_t* rng)
 {
-	const sound_type_t sound_type = footstep_sound_map_texture_name_hash_to_sound_type(map, texture_path_hash);
-	if (sound_type != SOUND_TYPE_UNKNOWN) {
-		for (size_t i = 0; i < map->groups.size; ++i) {
-			footstep_sound_group_t* group = map->groups.data + i;
-			if (group->type == sound_type && group->buffers.size != 0) {
-				size_t index = rand() % group->buffers.size;
-				DE_ASSERT(index < group->buffers.size);
-				return group->buffers.data[index];
-			}
+	if (!map->table) {
+		return NULL;
+	}
+	const size_t mask = map->table_size - 1;
+	for (size_t index = texture_path_hash & mask; map->table[index].group; index = (index + 1) & mask) {
+		if (map->table[index].texture_name_hash == texture_path_hash) {
+			const footstep_sound_group_t* group = map->table[index].group;
+			return group->buffers.data[rng_next_below(rng, (uint32_t)group->buffers.size)];
 		}
 	}
-
 	return NULL;
 }
\ No newline at end of file
@@ -37,13 +37,25 @@ typedef struct footstep_sound_group_t {
 	DE_ARRAY_DECLARE(de_resource_t*, buffers);
 } footstep_sound_group_t;
 
+/**
+ * @brief Slot of compiled texture hash to sound group table, empty if group is NULL.
+ */
+typedef struct footstep_sound_map_slot_t {
+	uint32_t texture_name_hash;
+	footstep_sound_group_t* group;
+} footstep_sound_map_slot_t;
+
 typedef struct footstep_sound_map_t {
 	DE_ARRAY_DECLARE(footstep_sound_type_map_entry_t, entries);
 	DE_ARRAY_DECLARE(footstep_sound_group_t, groups);
+	/* open-addressed table compiled from entries and groups after load, so probe
+	 * is O(1) regardless of amount of textures; size is always power of two */
+	footstep_sound_map_slot_t* table;
+	size_t table_size;
 } footstep_sound_map_t;
 
 void footstep_sound_map_read(de_core_t* core, footstep_sound_map_t* map);
 
 void footstep_sound_map_free(footstep_sound_map_t* map);
 
-de_resource_t* footstep_sound_map_probe(footstep_sound_map_t* map, uint32_t texture_path_hash);
\ No newline at end of file
+de_resource_t* footstep_sound_map_probe(footstep_sound_map_t* map, uint32_t texture_path_hash, rng_t* rng);
\ No newline at end of file
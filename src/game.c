@@ -25,73 +25,101 @@
 #include "weapon.c"
 #include "level.c"
 #include "player.c"
-#include "menu.c"
 #include "bot.c"
 #include "item.c"
 #include "actor.c"
 #include "footstep_sound_map.c"
-#include "hud.c"
 #include "projectile.c"
+#include "bench.c"
+#include "profiler.c"
+#include "job.c"
+#include "navigation.c"
+#include "savegame.c"
+#include "autosave.c"
+#include "ray_capsule.c"
+#include "hitscan.c"
+#include "asset_registry.c"
+#include "level_loader.c"
+#include "level_cache.c"
+#include "timer_wheel.c"
+#include "replay.c"
+#include "rng.c"
+#ifndef SHOOTER_DEDICATED_SERVER
+#include "menu.c"
+#include "hud.c"
+#include "sound_pool.c"
+#endif
 
 bool game_save(game_t* game)
 {
-	bool result = false;
-	if (game->level) {
-		result = true;
-
-		de_core_begin_visit(game->core);
-		{
-			de_object_visitor_t visitor;
-			de_object_visitor_init(game->core, &visitor);
-		
-			result &= de_core_visit(&visitor, game->core);
-			result &= DE_OBJECT_VISITOR_VISIT_POINTER(&visitor, "Level", &game->level, level_visit);
-
-		    /* debug output */
-			{
-				FILE* temp = fopen("save1.txt", "w");
-				de_object_visitor_print_tree(&visitor, temp);
-				fclose(temp);
-			}
+	/* debug text dump is opt-in, it is few times larger than save itself */
+	return savegame_save(game, GAME_SAVE_PATH, game->options.save_text_dump ? GAME_SAVE_TEXT_PATH : NULL);
+}
 
-			de_object_visitor_save_binary(&visitor, "save1.bin");
-			de_object_visitor_free(&visitor);
-		}
-		de_core_end_visit(game->core);
+/**
+ * @brief Stops recording or playing replay, recorded part is written to file.
+ */
+static void game_stop_replay(game_t* game)
+{
+	if (game->replay) {
+		replay_free(game->replay);
+		game->replay = NULL;
 	}
-	return result;
 }
 
-bool game_load(game_t* game)
+static bool game_is_playing_replay(const game_t* game)
 {
-	de_object_visitor_t visitor;
-	bool result = true;
-	
-	de_core_begin_visit(game->core);
-	{
-		de_object_visitor_load_binary(game->core, &visitor, "save1.bin");
-
-		if (game->level) {
-			level_free(game->level);
-		}
+	return game->replay && game->replay->mode == REPLAY_MODE_PLAY;
+}
 
-		result &= de_core_visit(&visitor, game->core);
-		result &= DE_OBJECT_VISITOR_VISIT_POINTER(&visitor, "Level", &game->level, level_visit);
-		
-		de_object_visitor_free(&visitor);
+bool game_load(game_t* game)
+{
+	if (game->replay && game->replay->started) {
+		/* loaded state is not part of replay stream, it can't be reproduced */
+		de_log("game: replay %s is stopped by load", game->replay->path);
+		game_stop_replay(game);
+	}
+	const bool result = savegame_load(game, GAME_SAVE_PATH);
+#ifndef SHOOTER_DEDICATED_SERVER
+	if (game->main_menu) {
+		menu_set_visible(game->main_menu, false);
 	}
-	de_core_end_visit(game->core);
-	
-	menu_set_visible(game->main_menu, false);
+#endif
 	return result;
 }
 
-static game_t* game_create(void)
+float game_get_tick_scale(const game_t* game)
+{
+	return (float)(game->time.delta * GAME_REFERENCE_TICK_RATE);
+}
+
+float game_get_smoothing(const game_t* game, float factor)
+{
+	return 1.0f - powf(1.0f - factor, game_get_tick_scale(game));
+}
+
+static game_t* game_create(const game_options_t* options)
 {
 	game_t* game = DE_NEW(game_t);
+	game->options = *options;
 	de_log_open("Shooter.log");
 
 	/* Init core */
+#ifdef SHOOTER_DEDICATED_SERVER
+	/* engine has no core init without window and renderer, so server asks for smallest
+	 * possible window that is never rendered to */
+	game->core = de_core_init(&(de_core_config_t)
+	{
+		.video_mode = (de_video_mode_t)
+		{
+			.width = 1,
+			.height = 1,
+			.bits_per_pixel = 32,
+			.fullscreen = false
+		},
+		.title = "Shooter Server"
+	});
+#else
 	game->core = de_core_init(&(de_core_config_t)
 	{
 		.video_mode = (de_video_mode_t)
@@ -103,9 +131,41 @@ static game_t* game_create(void)
 		},
 		.title = "Shooter"
 	});
+#endif
 	de_core_set_user_pointer(game->core, game);
+
+	/* replay is played with tick rate it was recorded with */
+	if (game->options.replay_path) {
+		game->replay = replay_open(game->options.replay_path);
+		if (game->replay) {
+			game->options.tick_rate = game->replay->tick_rate;
+		}
+	}
+
+	/* known before level is created, timers of items and projectiles are scheduled in ticks */
+	game->time.delta = 1.0 / game->options.tick_rate;
+
+	game->profiler = profiler_create();
+	game->jobs = job_system_create(game->options.worker_count);
+	game->random = rng_streams_create(game->options.seed);
+	if (!game->replay && game->options.record_path) {
+		game->replay = replay_create_recorder(game->options.record_path, LEVEL_TEST_MAP_PATH, game->options.tick_rate, game->options.seed);
+	}
+
+#ifndef SHOOTER_DEDICATED_SERVER
+	if (game->options.headless) {
+		/* simulation only, nothing to show or play */
+		return game;
+	}
+
+	game->sound_pool = sound_pool_create(de_core_get_sound_context(game->core), GAME_SOUND_VOICE_COUNT);
+
 	de_renderer_set_framerate_limit(de_core_get_renderer(game->core), 60);
 
+	if (game->options.autosave_interval > 0.0) {
+		game->autosave = autosave_create(game->options.autosave_interval, GAME_AUTOSAVE_PATH, GAME_AUTOSAVE_TEMP_PATH);
+	}
+
 	/* Create menu */
 	game->main_menu = menu_create(game);
 
@@ -114,80 +174,320 @@ static game_t* game_create(void)
 	/* Create overlay */
 	game->fps_text = de_gui_node_create(de_core_get_gui(game->core), DE_GUI_NODE_TEXT);
 
+	/* replay starts right away on map it was recorded on */
+	if (game_is_playing_replay(game)) {
+		game->loader = level_loader_create(game, game->replay->map_path, true);
+		menu_set_loading_progress(game->main_menu, 0.0f);
+	}
+#endif
+
 	return game;
 }
 
-static void game_main_loop(game_t* game)
+static bool game_is_paused(const game_t* game)
+{
+#ifdef SHOOTER_DEDICATED_SERVER
+	DE_UNUSED(game);
+	return false;
+#else
+	return game->main_menu && game->main_menu->visible;
+#endif
+}
+
+void game_simulate(game_t* game)
+{
+	profiler_t* profiler = game->profiler;
+	const double fixed_timestep = game->time.delta;
+
+	game->time.seconds += fixed_timestep;
+	++game->time.tick_count;
+
+	DE_LINKED_LIST_FOR_EACH_H(de_scene_t*, scene, de_core_get_first_scene(game->core))
+	{
+		profiler_begin_scope(profiler, PROFILER_SCOPE_SCENE);
+		de_scene_update(scene, fixed_timestep);
+		profiler_end_scope(profiler, PROFILER_SCOPE_SCENE);
+	}
+
+	/* world is frozen while menu is shown, so every simulated tick is also a tick of replay */
+	if (game->level && !game_is_paused(game)) {
+		if (game->replay) {
+			replay_tick(game->replay, game->level);
+			if (replay_is_finished(game->replay)) {
+				de_log("game: replay %s is over", game->replay->path);
+				game_stop_replay(game);
+			}
+		}
+
+		profiler_begin_scope(profiler, PROFILER_SCOPE_LEVEL);
+		level_update(game->level);
+		profiler_end_scope(profiler, PROFILER_SCOPE_LEVEL);
+
+		if (game->autosave) {
+			autosave_update(game->autosave, game);
+		}
+
+		level_store_body_positions(game->level);
+
+		profiler_begin_scope(profiler, PROFILER_SCOPE_PHYSICS);
+		de_physics_step(game->core, fixed_timestep);
+		profiler_end_scope(profiler, PROFILER_SCOPE_PHYSICS);
+	}
+}
+
+#ifndef SHOOTER_DEDICATED_SERVER
+
+static void game_update_stats_text(game_t* game)
 {
 	de_renderer_t* renderer = de_core_get_renderer(game->core);
+	profiler_t* profiler = game->profiler;
+	char buffer[2048];
+	int len = snprintf(buffer, sizeof(buffer), "Frame time: %.2f ms (p99: %.2f ms)\nFPS: (Mean: %d; Current: %d; Min: %d)\nDraw calls: %d\nAllocations: %d\n",
+		de_render_get_frame_time(renderer), profiler_get_percentile(profiler, PROFILER_SCOPE_COUNT, 99.0f) * 1000.0f,
+		(int)de_renderer_get_mean_fps(renderer), (int)renderer->current_fps, (int)renderer->min_fps,
+		(int)renderer->draw_calls, (int)de_get_alloc_count());
+	if (game->level && len > 0 && len < (int)sizeof(buffer)) {
+		len += snprintf(buffer + len, sizeof(buffer) - len, "Asset lookups saved: %d (total: %d)\n",
+			(int)game->level->assets.last_frame_lookups, (int)game->level->assets.total_lookups);
+	}
+	if (game->hud && len > 0 && len < (int)sizeof(buffer)) {
+		len += snprintf(buffer + len, sizeof(buffer) - len, "HUD text updates: %d\n", (int)game->hud->text_update_count);
+	}
+	if (len > 0 && len < (int)sizeof(buffer)) {
+		len += snprintf(buffer + len, sizeof(buffer) - len, "Ticks: %d at %d Hz (caught up: %d; dropped: %d)\n",
+			(int)game->time.tick_count, (int)game->options.tick_rate, (int)game->time.caught_up_ticks, (int)game->time.dropped_ticks);
+	}
+	if (len > 0 && len < (int)sizeof(buffer)) {
+		profiler_print(profiler, buffer + len, sizeof(buffer) - len);
+	}
+	de_gui_text_set_text_utf8(game->fps_text, buffer);
+}
+
+/**
+ * @brief Runs one fixed simulation tick.
+ */
+static void game_tick(game_t* game)
+{
 	de_gui_t* gui = de_core_get_gui(game->core);
-	const double fixed_fps = 60.0;
-	const double fixed_timestep = 1.0f / fixed_fps;
+	profiler_t* profiler = game->profiler;
+
+	profiler_begin_scope(profiler, PROFILER_SCOPE_EVENTS);
+	de_event_t evt;
+	while (de_core_poll_event(game->core, &evt)) {
+		bool processed = menu_process_event(game->main_menu, &evt);
+		if (!processed) {
+			processed = hud_process_event(game->hud, &evt);
+		}
+		if (!processed) {
+			processed = de_gui_process_event(gui, &evt);
+		}
+		if (!processed && game->level && !game_is_playing_replay(game)) {
+			processed = player_process_event(game->level->player, &evt);
+		}
+		/* dump profiler history, can be opened in chrome://tracing */
+		if (!processed && !game->main_menu->visible && evt.type == DE_EVENT_TYPE_KEY_DOWN && evt.s.key.key == DE_KEY_P) {
+			profiler_dump_chrome_trace(profiler, "profile.json");
+		}
+	}
+	profiler_end_scope(profiler, PROFILER_SCOPE_EVENTS);
+
+	profiler_begin_scope(profiler, PROFILER_SCOPE_SOUND);
+	de_sound_context_update(de_core_get_sound_context(game->core));
+	profiler_end_scope(profiler, PROFILER_SCOPE_SOUND);
+
+	profiler_begin_scope(profiler, PROFILER_SCOPE_GUI);
+	de_gui_update(gui);
+	profiler_end_scope(profiler, PROFILER_SCOPE_GUI);
+
+	game_simulate(game);
+}
+
+static void game_main_loop(game_t* game)
+{
+	de_renderer_t* renderer = de_core_get_renderer(game->core);
+	profiler_t* profiler = game->profiler;
+	const double fixed_timestep = game->time.delta;
 	game->time.seconds = de_time_get_seconds();
-	game->time.delta = fixed_timestep;
+	game->time.accumulator = 0.0;
+	double last_time = game->time.seconds;
+	double last_stats_time = 0.0;
 	while (de_core_is_running(game->core)) {
-		double dt = de_time_get_seconds() - game->time.seconds;
-		while (dt >= fixed_timestep) {
-			dt -= fixed_timestep;
-			game->time.seconds += fixed_timestep;
-
-			de_event_t evt;
-			while (de_core_poll_event(game->core, &evt)) {
-				bool processed = menu_process_event(game->main_menu, &evt);
-				if (!processed) {
-					processed = hud_process_event(game->hud, &evt);
-				}
-				if (!processed) {
-					processed = de_gui_process_event(gui, &evt);
-				}
-				if (!processed && game->level) {
-					processed = player_process_event(game->level->player, &evt);
+		profiler_begin_frame(profiler);
+
+		const double frame_start = de_time_get_seconds();
+		game->time.accumulator += frame_start - last_time;
+		last_time = frame_start;
+
+		/* simulation rate does not depend on render rate: frame runs as many fixed ticks as
+		 * real time requires, but no more than GAME_MAX_TICKS_PER_FRAME so slow frame can't
+		 * start spiral of ever longer frames; ticks beyond that limit are dropped and counted */
+		int pending = (int)(game->time.accumulator / fixed_timestep);
+		if (pending > GAME_MAX_TICKS_PER_FRAME) {
+			const int dropped = pending - GAME_MAX_TICKS_PER_FRAME;
+			game->time.dropped_ticks += (uint64_t)dropped;
+			game->time.accumulator -= dropped * fixed_timestep;
+			pending = GAME_MAX_TICKS_PER_FRAME;
+		}
+		if (pending > 1) {
+			game->time.caught_up_ticks += (uint64_t)(pending - 1);
+		}
+		for (int i = 0; i < pending; ++i) {
+			game->time.accumulator -= fixed_timestep;
+			game_tick(game);
+		}
+		game->time.alpha = (float)(game->time.accumulator / fixed_timestep);
+
+		if (game->loader) {
+			const bool loaded = level_loader_update(game->loader, GAME_LOADING_FRAME_BUDGET);
+			menu_set_loading_progress(game->main_menu, loaded ? -1.0f : level_loader_get_progress(game->loader));
+			if (loaded) {
+				game->level = level_loader_finish(game->loader);
+				game->loader = NULL;
+				menu_set_visible(game->main_menu, false);
+				if (game->replay) {
+					replay_begin(game->replay, game->level);
 				}
 			}
+		}
 
-			de_sound_context_update(de_core_get_sound_context(game->core));
-			de_gui_update(gui);
-			
-			DE_LINKED_LIST_FOR_EACH_H(de_scene_t*, scene, de_core_get_first_scene(game->core))
-			{
-				de_scene_update(scene, fixed_timestep);
-			}
+		/* render state between last two ticks, so motion is smooth with any tick rate; paused
+		 * level does not tick, so its stored states are stale and it is rendered as is */
+		profiler_begin_scope(profiler, PROFILER_SCOPE_RENDER);
+		const bool interpolate = game->level && !game_is_paused(game);
+		if (interpolate) {
+			level_interpolate_body_positions(game->level, game->time.alpha);
+		}
+		de_renderer_render(renderer);
+		if (interpolate) {
+			level_restore_body_positions(game->level);
+		}
+		profiler_end_scope(profiler, PROFILER_SCOPE_RENDER);
 
-			if (game->level && !game->main_menu->visible) {
-				level_update(game->level,(float) dt);
-			}
-			de_physics_step(game->core, fixed_timestep);
+		profiler_end_frame(profiler);
+		if (game->level) {
+			asset_registry_end_frame(&game->level->assets);
+		}
 
-			if (dt >= 4 * fixed_timestep) {
-				game->time.seconds = de_time_get_seconds();
-				break;
-			}
+		/* statistics text is formatted and laid out only a few times per second */
+		const double now = de_time_get_seconds();
+		if (now - last_stats_time >= GAME_STATS_UPDATE_INTERVAL) {
+			last_stats_time = now;
+			game_update_stats_text(game);
 		}
+	}
+}
+#else
+/**
+ * @brief Runs fixed ticks in real time until core is stopped, sleeping between ticks.
+ * Ticks that take longer than tick budget are counted, tick time percentiles are
+ * logged every GAME_SERVER_REPORT_INTERVAL seconds.
+ */
+static void game_server_loop(game_t* game)
+{
+	profiler_t* profiler = game->profiler;
+	const double fixed_timestep = game->time.delta;
+	const double budget = game->options.tick_budget > 0.0 ? game->options.tick_budget : fixed_timestep;
+	uint64_t over_budget_ticks = 0;
+
+	if (game_is_playing_replay(game)) {
+		level_loader_t* loader = level_loader_create(game, game->replay->map_path, true);
+		level_loader_update(loader, INFINITY);
+		game->level = level_loader_finish(loader);
+	} else {
+		game->level = level_create_test(game);
+	}
+	if (game->replay) {
+		replay_begin(game->replay, game->level);
+	}
+	de_log("server: running at %d Hz, tick budget %.2f ms", (int)game->options.tick_rate, budget * 1000.0);
 
-		de_renderer_render(renderer);
+	double next_tick_time = de_time_get_seconds();
+	double last_report_time = next_tick_time;
+	while (de_core_is_running(game->core)) {
+		double now = de_time_get_seconds();
+		if (now < next_tick_time) {
+			de_sleep((int)((next_tick_time - now) * 1000.0));
+			continue;
+		}
+
+		/* nobody reads window events on server, they are only drained */
+		de_event_t evt;
+		while (de_core_poll_event(game->core, &evt)) {
+			DE_UNUSED(evt);
+		}
+
+		profiler_begin_frame(profiler);
+		game_simulate(game);
+		profiler_end_frame(profiler);
 
-		/* print statistics */
-		char buffer[1024];
-		snprintf(buffer, sizeof(buffer), "Frame time: %.2f ms\nFPS: (Mean: %d; Current: %d; Min: %d)\nDraw calls: %d\nAllocations: %d",
-			de_render_get_frame_time(renderer),
-			(int)de_renderer_get_mean_fps(renderer), (int)renderer->current_fps, (int)renderer->min_fps,
-			(int)renderer->draw_calls, (int)de_get_alloc_count());
-		de_gui_text_set_text_utf8(game->fps_text, buffer);
+		const double tick_end = de_time_get_seconds();
+		if (tick_end - now > budget) {
+			++over_budget_ticks;
+		}
+
+		/* same catch-up rule as in client: at most GAME_MAX_TICKS_PER_FRAME ticks behind */
+		next_tick_time += fixed_timestep;
+		const double behind = tick_end - next_tick_time;
+		if (behind > GAME_MAX_TICKS_PER_FRAME * fixed_timestep) {
+			const uint64_t dropped = (uint64_t)(behind / fixed_timestep);
+			game->time.dropped_ticks += dropped;
+			next_tick_time += (double)dropped * fixed_timestep;
+		} else if (behind > 0.0) {
+			++game->time.caught_up_ticks;
+		}
+
+		if (tick_end - last_report_time >= GAME_SERVER_REPORT_INTERVAL) {
+			last_report_time = tick_end;
+			de_log("server: tick %d, p50=%.3f ms p99=%.3f ms, over budget %d, caught up %d, dropped %d",
+				(int)game->time.tick_count, profiler_get_percentile(profiler, PROFILER_SCOPE_COUNT, 50.0f) * 1000.0f,
+				profiler_get_percentile(profiler, PROFILER_SCOPE_COUNT, 99.0f) * 1000.0f, (int)over_budget_ticks,
+				(int)game->time.caught_up_ticks, (int)game->time.dropped_ticks);
+		}
 	}
 }
+#endif
 
 static void game_close(game_t* game)
 {
+	de_log("game: %d ticks at %d Hz, caught up %d, dropped %d", (int)game->time.tick_count, (int)game->options.tick_rate,
+		(int)game->time.caught_up_ticks, (int)game->time.dropped_ticks);
+
+	if (game->autosave) {
+		autosave_free(game->autosave);
+	}
+
+	game_stop_replay(game);
+
+	if (game->loader) {
+		level_loader_free(game->loader);
+	}
 	if (game->level) {
 		level_free(game->level);
 	}
 
-	hud_free(game->hud);
+#ifndef SHOOTER_DEDICATED_SERVER
+	if (game->hud) {
+		hud_free(game->hud);
+	}
 
-	menu_free(game->main_menu);
+	if (game->main_menu) {
+		menu_free(game->main_menu);
+	}
+
+	/* sources belong to sound context, so pool must go before core */
+	if (game->sound_pool) {
+		sound_pool_free(game->sound_pool);
+	}
+#endif
 
 	de_core_shutdown(game->core);
 
+	job_system_free(game->jobs);
+
+	rng_streams_free(game->random);
+
+	profiler_free(game->profiler);
+
 	de_free(game);
 }
 
@@ -204,16 +504,89 @@ void test_ray_cap()
 	}
 }
 
+/**
+ * @brief Parses command line. Supported options:
+ *  -headless        - simulate level without rendering and print timings, for CI.
+ *  -ticks <count>   - amount of fixed steps to simulate in headless mode.
+ *  -bots <count>    - amount of extra bots to spawn in headless mode.
+ *  -workers <count> - amount of worker threads, 0 to run everything on main thread.
+ *  -tickrate <hz>   - fixed simulation steps per second, rendering is interpolated between them.
+ *  -record <path>   - record input of new game to replay file.
+ *  -replay <path>   - play replay file, in headless mode it replaces bot count and tick count.
+ *  -seed <number>   - seed of game randomness, by default it is taken from clock (fixed in headless mode).
+ *  -tickbudget <ms> - dedicated server only: tick time that is counted as overrun, one tick by default.
+ */
+static void game_parse_options(int argc, char** argv, game_options_t* options)
+{
+	options->headless = false;
+	options->bench_ticks = 3600;
+	options->bench_bots = 0;
+	options->worker_count = 3;
+	options->save_text_dump = false;
+	options->autosave_interval = 30.0;
+	options->tick_rate = GAME_DEFAULT_TICK_RATE;
+	options->record_path = NULL;
+	options->replay_path = NULL;
+	options->tick_budget = 0.0;
+	bool has_seed = false;
+	for (int i = 1; i < argc; ++i) {
+		const char* arg = argv[i];
+		const bool has_value = i + 1 < argc;
+		if (strcmp(arg, "-headless") == 0) {
+			options->headless = true;
+		} else if (strcmp(arg, "-ticks") == 0 && has_value) {
+			options->bench_ticks = atoi(argv[++i]);
+		} else if (strcmp(arg, "-bots") == 0 && has_value) {
+			options->bench_bots = atoi(argv[++i]);
+		} else if (strcmp(arg, "-workers") == 0 && has_value) {
+			options->worker_count = atoi(argv[++i]);
+		} else if (strcmp(arg, "-savedump") == 0) {
+			options->save_text_dump = true;
+		} else if (strcmp(arg, "-autosave") == 0 && has_value) {
+			options->autosave_interval = atof(argv[++i]);
+		} else if (strcmp(arg, "-record") == 0 && has_value) {
+			options->record_path = argv[++i];
+		} else if (strcmp(arg, "-replay") == 0 && has_value) {
+			options->replay_path = argv[++i];
+		} else if (strcmp(arg, "-tickbudget") == 0 && has_value) {
+			options->tick_budget = atof(argv[++i]) / 1000.0;
+		} else if (strcmp(arg, "-seed") == 0 && has_value) {
+			options->seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+			has_seed = true;
+		} else if (strcmp(arg, "-tickrate") == 0 && has_value) {
+			const double tick_rate = atof(argv[++i]);
+			if (tick_rate >= GAME_MIN_TICK_RATE && tick_rate <= GAME_MAX_TICK_RATE) {
+				options->tick_rate = tick_rate;
+			} else {
+				de_log("game: tick rate must be in [%d; %d] Hz, %d Hz is used", (int)GAME_MIN_TICK_RATE, (int)GAME_MAX_TICK_RATE, (int)options->tick_rate);
+			}
+		} else {
+			de_log("game: unknown command line option %s", arg);
+		}
+	}
+	if (!has_seed) {
+		options->seed = options->headless ? GAME_HEADLESS_SEED : (uint32_t)(de_time_get_seconds() * 1000000.0);
+	}
+}
+
 int main(int argc, char** argv)
 {
 	test_ray_cap();
 
-	DE_UNUSED(argc);
-	DE_UNUSED(argv);
+	game_options_t options;
+	game_parse_options(argc, argv, &options);
 
-	game_t* game = game_create();
+	game_t* game = game_create(&options);
 
-	game_main_loop(game);
+	if (options.headless) {
+		bench_run_simulation(game);
+	} else {
+#ifdef SHOOTER_DEDICATED_SERVER
+		game_server_loop(game);
+#else
+		game_main_loop(game);
+#endif
+	}
 
 	game_close(game);
 
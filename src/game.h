@@ -31,40 +31,125 @@ typedef struct bot_t bot_t;
 typedef struct actor_t actor_t;
 typedef struct hud_t hud_t;
 typedef struct item_t item_t;
+typedef struct profiler_t profiler_t;
+typedef struct job_system_t job_system_t;
+typedef struct autosave_t autosave_t;
+typedef struct sound_pool_t sound_pool_t;
+typedef struct level_loader_t level_loader_t;
+typedef struct rng_streams_t rng_streams_t;
 
 typedef struct game_time_t {
 	double seconds; /* Time from start. */
-	double delta; /* Time since last update tick. */
+	double delta; /* Duration of one fixed simulation tick, 1 / tick rate. */
+	double accumulator; /**< Real time that is not simulated yet, less than delta after ticks of frame. */
+	float alpha; /**< Position of rendered frame between last two simulated states, [0; 1). */
+	uint64_t tick_count; /**< Total amount of simulated ticks. */
+	uint64_t caught_up_ticks; /**< Extra ticks run in one frame to catch up with real time. */
+	uint64_t dropped_ticks; /**< Ticks skipped because frame was more than GAME_MAX_TICKS_PER_FRAME behind. */
 } game_time_t;
 
+/**
+ * @brief Options parsed from command line.
+ */
+typedef struct game_options_t {
+	bool headless; /**< Run simulation only: no menu, hud, gui, sound or rendering. */
+	int bench_ticks; /**< Amount of fixed steps to simulate in headless mode. */
+	int bench_bots; /**< Amount of extra bots to spawn in headless mode. */
+	int worker_count; /**< Amount of worker threads of job system, 0 - run everything on main thread. */
+	bool save_text_dump; /**< Write human-readable copy of each save, for debugging. */
+	double autosave_interval; /**< Seconds between autosaves, 0 - autosave is disabled. */
+	double tick_rate; /**< Fixed simulation steps per second, independent of render rate. */
+	const char* record_path; /**< Record input of new game to this file, NULL - do not record. */
+	const char* replay_path; /**< Play this replay instead of player input, NULL - no replay. */
+	uint32_t seed; /**< Seed of game randomness, replay overrides it with recorded one. */
+	double tick_budget; /**< Dedicated server: seconds tick may take before it is counted as overrun, 0 - one tick. */
+} game_options_t;
+
 struct game_t {
 	de_core_t* core;
 	level_t* level;
+	level_loader_t* loader; /**< Not NULL while new game is loading. */
 	menu_t* main_menu;
 	hud_t* hud;
 	de_gui_node_t* fps_text;
 	game_time_t time;
+	game_options_t options;
+	profiler_t* profiler;
+	job_system_t* jobs;
+	autosave_t* autosave; /**< NULL if autosave is disabled. */
+	sound_pool_t* sound_pool; /**< One-shot sounds (shots, footsteps). */
+	struct replay_t* replay; /**< Recorder or played replay, NULL if neither is requested. */
+	rng_streams_t* random; /**< All gameplay randomness comes from here, never from rand(). */
 };
 
+#define GAME_SOUND_VOICE_COUNT 24
+#define GAME_DEFAULT_TICK_RATE 60.0
+#define GAME_HEADLESS_SEED 1u /**< Headless runs are reproducible unless -seed is given. */
+#define GAME_MIN_TICK_RATE 10.0
+#define GAME_MAX_TICK_RATE 240.0
+#define GAME_REFERENCE_TICK_RATE 60.0 /**< Tick rate which per-tick constants of gameplay code were tuned for. */
+#define GAME_MAX_TICKS_PER_FRAME 4 /**< Frame simulates at most this amount of ticks, rest is dropped. */
+#define GAME_STATS_UPDATE_INTERVAL 0.25 /**< Seconds between updates of statistics text. */
+#define GAME_SERVER_REPORT_INTERVAL 10.0 /**< Seconds between tick time reports of dedicated server. */
+#define GAME_LOADING_FRAME_BUDGET 0.008 /**< Seconds of each frame given to level loader. */
+#define GAME_SAVE_PATH "save1.bin"
+#define GAME_SAVE_TEXT_PATH "save1.txt"
+#define GAME_AUTOSAVE_PATH "autosave.bin"
+#define GAME_AUTOSAVE_TEMP_PATH "autosave.bin.tmp"
+
 bool game_save(game_t* game);
 
 bool game_load(game_t* game);
 
+/**
+ * @brief Returns duration of fixed tick relative to GAME_REFERENCE_TICK_RATE tick, so
+ * per-tick increments stay the same per second with any tick rate.
+ */
+float game_get_tick_scale(const game_t* game);
+
+/**
+ * @brief Converts factor of per-tick exponential smoothing (x += (dest - x) * factor) tuned
+ * for GAME_REFERENCE_TICK_RATE to factor that gives same smoothing per second with current tick rate.
+ */
+float game_get_smoothing(const game_t* game, float factor);
+
+/**
+ * @brief Simulation part of fixed tick (scene, level, physics), same for client,
+ * dedicated server and headless benchmark.
+ */
+void game_simulate(game_t* game);
+
 typedef struct actor_dispatch_table_t {
 	void(*init)(actor_t* actor);
 	void(*deinit)(actor_t* actor);
 	void(*update)(actor_t* actor);
-	bool(*visit)(de_object_visitor_t* visitor, actor_t* actor);
 	bool(*process_event)(actor_t* actor, const de_event_t* evt);
 } actor_dispatch_table_t;
 
+#include "rng.h"
+#include "profiler.h"
+#include "job.h"
+#include "timer_wheel.h"
+#include "navigation.h"
 #include "footstep_sound_map.h"
+#include "bot.h"
+#include "actor.h"
+#include "ray_capsule.h"
+#include "hitscan.h"
+#include "asset_registry.h"
+#include "projectile.h"
+#include "item.h"
 #include "level.h"
+#include "level_cache.h"
+#include "level_loader.h"
 #include "weapon.h"
-#include "item.h"
 #include "player.h"
+#include "bench.h"
+#include "savegame.h"
+#include "autosave.h"
+#ifndef SHOOTER_DEDICATED_SERVER
+#include "sound_pool.h"
 #include "menu.h"
-#include "bot.h"
-#include "actor.h"
 #include "hud.h"
-#include "projectile.h"
\ No newline at end of file
+#endif
+#include "replay.h"
\ No newline at end of file
@@ -0,0 +1,182 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+void hitscan_init(hitscan_t* hitscan)
+{
+	memset(hitscan, 0, sizeof(*hitscan));
+}
+
+static void hitscan_targets_free(hitscan_targets_t* targets)
+{
+	if (targets->capacity) {
+		de_free(targets->x);
+		de_free(targets->y);
+		de_free(targets->z);
+		de_free(targets->half_height);
+		de_free(targets->radius);
+		de_free(targets->hit_t);
+		de_free(targets->actors);
+	}
+	memset(targets, 0, sizeof(*targets));
+}
+
+void hitscan_deinit(hitscan_t* hitscan)
+{
+	DE_ARRAY_FREE(hitscan->shots);
+	DE_ARRAY_FREE(hitscan->results);
+	DE_ARRAY_FREE(hitscan->world_hits);
+	hitscan_targets_free(&hitscan->targets);
+}
+
+void hitscan_queue_shot(hitscan_t* hitscan, const de_ray_t* ray, float damage, actor_t* shooter)
+{
+	const hitscan_shot_t shot = {
+		.ray = *ray,
+		.damage = damage,
+		.shooter = shooter
+	};
+	DE_ARRAY_APPEND(hitscan->shots, shot);
+}
+
+void hitscan_queue_shot_with_world_hit(hitscan_t* hitscan, const de_ray_t* ray, float damage, actor_t* shooter,
+	float world_hit_distance, const de_vec3_t* world_hit_position)
+{
+	const hitscan_shot_t shot = {
+		.ray = *ray,
+		.damage = damage,
+		.shooter = shooter,
+		.world_hit_known = true,
+		.world_hit_distance = world_hit_distance,
+		.world_hit_position = *world_hit_position
+	};
+	DE_ARRAY_APPEND(hitscan->shots, shot);
+}
+
+static void hitscan_targets_reserve(hitscan_targets_t* targets, size_t capacity)
+{
+	if (targets->capacity >= capacity) {
+		return;
+	}
+	hitscan_targets_free(targets);
+	targets->capacity = capacity * 2;
+	targets->x = de_malloc(targets->capacity * sizeof(*targets->x));
+	targets->y = de_malloc(targets->capacity * sizeof(*targets->y));
+	targets->z = de_malloc(targets->capacity * sizeof(*targets->z));
+	targets->half_height = de_malloc(targets->capacity * sizeof(*targets->half_height));
+	targets->radius = de_malloc(targets->capacity * sizeof(*targets->radius));
+	targets->hit_t = de_malloc(targets->capacity * sizeof(*targets->hit_t));
+	targets->actors = de_malloc(targets->capacity * sizeof(*targets->actors));
+}
+
+static void hitscan_gather_targets(hitscan_targets_t* targets, level_t* level)
+{
+	size_t count = 0;
+	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+		++count;
+	}
+	hitscan_targets_reserve(targets, count);
+	targets->count = 0;
+	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+		const size_t i = targets->count++;
+		de_vec3_t position;
+		de_node_get_global_position(actor->pivot, &position);
+		de_capsule_shape_t* capsule = de_convex_shape_to_capsule(de_body_get_shape(actor->body));
+		targets->x[i] = position.x;
+		targets->y[i] = position.y;
+		targets->z[i] = position.z;
+		targets->half_height[i] = de_capsule_shape_get_height(capsule) * 0.5f;
+		targets->radius[i] = de_capsule_shape_get_radius(capsule);
+		targets->actors[i] = actor;
+	}
+}
+
+void hitscan_resolve(hitscan_t* hitscan, level_t* level)
+{
+	DE_ARRAY_CLEAR(hitscan->results);
+	if (!hitscan->shots.size) {
+		return;
+	}
+
+	/* capsules are gathered once for whole batch, not per shot */
+	hitscan_gather_targets(&hitscan->targets, level);
+	const hitscan_targets_t* targets = &hitscan->targets;
+	const ray_capsule_soa_t capsules = {
+		.x = targets->x,
+		.y = targets->y,
+		.z = targets->z,
+		.half_height = targets->half_height,
+		.radius = targets->radius,
+		.count = targets->count
+	};
+
+	for (size_t i = 0; i < hitscan->shots.size; ++i) {
+		const hitscan_shot_t* shot = hitscan->shots.data + i;
+		const float dir_len = de_vec3_len(&shot->ray.dir);
+		hitscan_result_t result = { 0 };
+
+		/* world: static geometry only, closest hit by linear scan instead of sort */
+		float closest = FLT_MAX;
+		if (shot->world_hit_known) {
+			const float t = shot->world_hit_distance / dir_len;
+			if (t <= 1.0f) {
+				closest = t;
+				result.hit = true;
+				result.position = shot->world_hit_position;
+			}
+		} else if (de_ray_cast(level->scene, &shot->ray, DE_RAY_CAST_FLAGS_IGNORE_BODY, &hitscan->world_hits)) {
+			for (size_t k = 0; k < hitscan->world_hits.size; ++k) {
+				const de_ray_cast_result_t* world_hit = hitscan->world_hits.data + k;
+				const float t = sqrtf(world_hit->sqr_distance) / dir_len;
+				if (t < closest) {
+					closest = t;
+					result.hit = true;
+					result.position = world_hit->position;
+				}
+			}
+		}
+
+		/* actors: all capsules at once, then closest one */
+		ray_capsule_intersect_many(&shot->ray, &capsules, targets->hit_t);
+		for (size_t k = 0; k < targets->count; ++k) {
+			const float t = targets->hit_t[k];
+			if (t < closest && targets->actors[k] != shot->shooter) {
+				closest = t;
+				result.hit = true;
+				result.actor = targets->actors[k];
+			}
+		}
+
+		if (result.actor) {
+			de_vec3_t offset;
+			de_vec3_scale(&offset, &shot->ray.dir, closest);
+			de_vec3_add(&result.position, &shot->ray.origin, &offset);
+			result.actor->health -= shot->damage;
+			if (result.actor->health < 0.0f) {
+				result.actor->health = 0.0f;
+			}
+		}
+
+		DE_ARRAY_APPEND(hitscan->results, result);
+	}
+
+	DE_ARRAY_CLEAR(hitscan->shots);
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+typedef struct hitscan_shot_t {
+	de_ray_t ray; /**< Direction is scaled by range of weapon. */
+	float damage;
+	actor_t* shooter; /**< Never hit by own shot, can be NULL. */
+	bool world_hit_known; /**< World was already queried along same ray, query is skipped. */
+	float world_hit_distance; /**< Valid if world_hit_known, FLT_MAX if world was not hit. */
+	de_vec3_t world_hit_position;
+} hitscan_shot_t;
+
+typedef struct hitscan_result_t {
+	bool hit; /**< False if shot hit nothing within range. */
+	actor_t* actor; /**< Hit actor or NULL if shot hit world. */
+	de_vec3_t position;
+} hitscan_result_t;
+
+/**
+ * @brief Capsules of every actor, gathered once per batch in structure-of-arrays
+ * layout so all queued shots are tested against linear arrays. Capsules are
+ * vertical (Y axis), center is position of actor.
+ */
+typedef struct hitscan_targets_t {
+	size_t count;
+	size_t capacity;
+	float* x;
+	float* y;
+	float* z;
+	float* half_height; /**< Half of distance between centers of capsule caps. */
+	float* radius;
+	float* hit_t; /**< Per-capsule result of ray test of current shot. */
+	actor_t** actors;
+} hitscan_targets_t;
+
+/**
+ * @brief Shots fired during tick are queued and resolved in one batch: world is
+ * queried without sorting and closest hit is found in one linear pass, actors are
+ * tested against capsules instead of physics bodies.
+ */
+typedef struct hitscan_t {
+	DE_ARRAY_DECLARE(hitscan_shot_t, shots);
+	DE_ARRAY_DECLARE(hitscan_result_t, results); /**< One per shot of last resolved batch. */
+	hitscan_targets_t targets;
+	de_ray_cast_result_array_t world_hits;
+} hitscan_t;
+
+void hitscan_init(hitscan_t* hitscan);
+
+void hitscan_deinit(hitscan_t* hitscan);
+
+void hitscan_queue_shot(hitscan_t* hitscan, const de_ray_t* ray, float damage, actor_t* shooter);
+
+/**
+ * @brief Same as hitscan_queue_shot, but with result of world query that was
+ * already done along same ray (laser sight), so it is not repeated.
+ */
+void hitscan_queue_shot_with_world_hit(hitscan_t* hitscan, const de_ray_t* ray, float damage, actor_t* shooter,
+	float world_hit_distance, const de_vec3_t* world_hit_position);
+
+/**
+ * @brief Resolves every queued shot, applies damage to hit actors and clears queue.
+ * Results stay in hitscan->results until next call.
+ */
+void hitscan_resolve(hitscan_t* hitscan, level_t* level);
\ No newline at end of file
@@ -24,6 +24,9 @@ hud_t* hud_create(game_t* game)
 	hud_t* hud = DE_NEW(hud_t);
 	de_gui_t* gui = de_core_get_gui(game->core);
 	hud->game = game;
+	/* never shown values, so first update sets both texts */
+	hud->shown_health = INT_MIN;
+	hud->shown_ammo = SIZE_MAX;
 
 	de_video_mode_t current_video_mode = de_core_get_current_video_mode(game->core);
 
@@ -94,11 +97,20 @@ void hud_update(hud_t* hud, float health, size_t ammo)
 	DE_ASSERT(hud);
 
 	char buffer[512];
-	snprintf(buffer, sizeof(buffer), "Health: %.1f", health);
-	de_gui_text_set_text_utf8(hud->health, buffer);
+	const int health_tenths = (int)floorf(health * 10.0f + 0.5f);
+	if (health_tenths != hud->shown_health) {
+		hud->shown_health = health_tenths;
+		snprintf(buffer, sizeof(buffer), "Health: %.1f", (float)health_tenths / 10.0f);
+		de_gui_text_set_text_utf8(hud->health, buffer);
+		++hud->text_update_count;
+	}
 
-	snprintf(buffer, sizeof(buffer), "Ammo: %d", (int)ammo);
-	de_gui_text_set_text_utf8(hud->ammo, buffer);
+	if (ammo != hud->shown_ammo) {
+		hud->shown_ammo = ammo;
+		snprintf(buffer, sizeof(buffer), "Ammo: %d", (int)ammo);
+		de_gui_text_set_text_utf8(hud->ammo, buffer);
+		++hud->text_update_count;
+	}
 }
 
 void hud_set_visible(hud_t* hud, bool visible)
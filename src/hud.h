@@ -25,6 +25,11 @@ struct hud_t {
 
 	de_gui_node_t* ammo;
 	de_gui_node_t* health;
+
+	/* values that are on screen now, text is rebuilt only when they change */
+	int shown_health; /**< In tenths, same precision as text. */
+	size_t shown_ammo;
+	size_t text_update_count; /**< How many times text was actually rebuilt, shown on stats overlay. */
 };
 
 hud_t* hud_create(game_t* game);
@@ -33,6 +38,10 @@ void hud_free(hud_t* hud);
 
 void hud_set_visible(hud_t* hud, bool visible);
 
+/**
+ * @brief Cheap to call every tick, texts are formatted and laid out only when
+ * shown values change.
+ */
 void hud_update(hud_t* hud, float health, size_t ammo);
 
 bool hud_process_event(hud_t* hud, de_event_t* evt);
\ No newline at end of file
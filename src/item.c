@@ -25,7 +25,7 @@ const item_definition_t* item_definition_from_item_type(item_type_t type)
 		case ITEM_TYPE_MEDKIT: {
 			static item_definition_t definition = {
 				.health_restore = 25,
-				.model_path = "data/models/medkit.fbx",
+				.model = ASSET_MODEL_MEDKIT,
 				.reactivation_time = 30.0f
 			};
 			return &definition;
@@ -35,7 +35,7 @@ const item_definition_t* item_definition_from_item_type(item_type_t type)
 				.max_ammo = 200,
 				.pick_up_ammo = 40,
 				.damage = 20,
-				.model_path = "data/models/m4/m4.fbx",
+				.model = ASSET_MODEL_M4,
 				.reactivation_time = 45.0f
 			};
 			return &definition;
@@ -45,7 +45,7 @@ const item_definition_t* item_definition_from_item_type(item_type_t type)
 				.max_ammo = 220,
 				.pick_up_ammo = 35,
 				.damage = 17.5,
-				.model_path = "data/models/ak47/ak47.fbx",
+				.model = ASSET_MODEL_AK47,
 				.reactivation_time = 45.0f
 			};
 			return &definition;
@@ -55,23 +55,39 @@ const item_definition_t* item_definition_from_item_type(item_type_t type)
 	return NULL;
 }
 
+bool item_type_from_name(const char* name, item_type_t* type)
+{
+	static const struct {
+		const char* name;
+		item_type_t type;
+	} names[] = {
+		{ "Medkit", ITEM_TYPE_MEDKIT },
+		{ "AK47", ITEM_TYPE_AK47 },
+		{ "M4", ITEM_TYPE_M4 },
+	};
+	for (size_t i = 0; i < DE_ARRAY_SIZE(names); ++i) {
+		if (strncmp(name, names[i].name, strlen(names[i].name)) == 0) {
+			*type = names[i].type;
+			return true;
+		}
+	}
+	return false;
+}
+
 item_t* item_create(level_t* level, item_type_t type)
 {
 	item_t* item = DE_NEW(item_t);
 	item->level = level;
 	item->type = type;
-	item->time_until_reactivation = 0.0f;
 
-	de_path_t model_path;
 	const item_definition_t* definition = item_definition_from_item_type(type);
-	de_path_from_cstr_as_view(&model_path, definition->model_path);
-
-	de_resource_t* model_resource = de_core_request_resource(level->game->core, DE_RESOURCE_TYPE_MODEL, &model_path);
-	if (model_resource) {
-		item->model = de_model_instantiate(de_resource_to_model(model_resource), level->scene);
+	de_model_t* model = asset_registry_get_model(&level->assets, definition->model);
+	if (model) {
+		item->model = de_model_instantiate(model, level->scene);
 	}
 
 	DE_ARRAY_APPEND(level->items, item);
+	level->item_grid.dirty = true;
 
 	return item;
 }
@@ -79,38 +95,208 @@ item_t* item_create(level_t* level, item_type_t type)
 bool item_is_active(item_t* item)
 {
 	DE_ASSERT(item);
-	return item->time_until_reactivation == 0.0f;
+	return !game_timer_is_scheduled(&item->reactivation_timer);
 }
 
 void item_set_position(item_t* item, const de_vec3_t* pos)
 {
 	DE_ASSERT(item);
+	item->position = *pos;
 	de_node_set_local_position(item->model, pos);
+	item->level->item_grid.dirty = true;
 }
 
 void item_free(item_t* item)
 {
 	DE_ASSERT(item);
 	DE_ARRAY_REMOVE(item->level->items, item);
+	item->level->item_grid.dirty = true;
+	timer_wheel_cancel(&item->level->timers, &item->reactivation_timer);
 	de_node_free(item->model);
 	de_free(item);
 }
 
+static void item_on_reactivation(game_timer_t* timer, void* user_data)
+{
+	DE_UNUSED(timer);
+	item_t* item = user_data;
+	de_node_set_local_visibility(item->model, true);
+}
+
+void item_set_time_until_reactivation(item_t* item, float time)
+{
+	DE_ASSERT(item);
+	level_t* level = item->level;
+	const double tick_duration = level->game->time.delta;
+	DE_ASSERT(tick_duration > 0);
+	const uint64_t ticks = timer_wheel_ticks_from_seconds(time, tick_duration);
+	if (ticks) {
+		timer_wheel_schedule(&level->timers, &item->reactivation_timer, ticks, item_on_reactivation, item);
+	} else {
+		timer_wheel_cancel(&level->timers, &item->reactivation_timer);
+	}
+	de_node_set_local_visibility(item->model, ticks == 0);
+}
+
+float item_get_time_until_reactivation(const item_t* item)
+{
+	DE_ASSERT(item);
+	const uint64_t ticks = timer_wheel_get_remaining(&item->level->timers, &item->reactivation_timer);
+	return (float)((double)ticks * item->level->game->time.delta);
+}
+
 void item_deactivate(item_t* item)
 {
 	DE_ASSERT(item);
-	DE_ASSERT(!item_is_active(item));
+	DE_ASSERT(item_is_active(item));
 	const item_definition_t* definition = item_definition_from_item_type(item->type);
-	item->time_until_reactivation = definition->reactivation_time;
+	item_set_time_until_reactivation(item, definition->reactivation_time);
 }
 
-void item_update(item_t* item, float dt)
+static weapon_t* item_find_weapon(actor_t* actor, weapon_type_t type)
 {
-	DE_ASSERT(item);
-	if (item->time_until_reactivation > 0) {
-		item->time_until_reactivation -= dt;
-		if (item->time_until_reactivation < 0) {
-			item->time_until_reactivation = 0.0f;
+	if (actor->type != ACTOR_TYPE_PLAYER) {
+		return NULL;
+	}
+	player_t* player = actor_to_player(actor);
+	for (size_t i = 0; i < player->weapons.size; ++i) {
+		if (player->weapons.data[i]->type == type) {
+			return player->weapons.data[i];
 		}
 	}
+	return NULL;
+}
+
+bool item_pick_up(item_t* item, actor_t* actor)
+{
+	DE_ASSERT(item_is_active(item));
+	const item_definition_t* definition = item_definition_from_item_type(item->type);
+	switch (item->type) {
+		case ITEM_TYPE_MEDKIT:
+			if (actor->health >= ACTOR_MAX_HEALTH) {
+				return false;
+			}
+			actor->health += (float)definition->health_restore;
+			if (actor->health > ACTOR_MAX_HEALTH) {
+				actor->health = ACTOR_MAX_HEALTH;
+			}
+			break;
+		case ITEM_TYPE_AK47:
+		case ITEM_TYPE_M4: {
+			weapon_t* wpn = item_find_weapon(actor, item->type == ITEM_TYPE_AK47 ? WEAPON_TYPE_AK47 : WEAPON_TYPE_M4);
+			if (!wpn || wpn->ammo >= definition->max_ammo) {
+				return false;
+			}
+			wpn->ammo += (uint32_t)definition->pick_up_ammo;
+			if (wpn->ammo > definition->max_ammo) {
+				wpn->ammo = (uint32_t)definition->max_ammo;
+			}
+			break;
+		}
+		default:
+			return false;
+	}
+	item_deactivate(item);
+	return true;
+}
+
+static size_t item_grid_bucket(const item_grid_t* grid, int x, int z)
+{
+	return (size_t)(((uint32_t)x * 73856093u) ^ ((uint32_t)z * 19349663u)) & (grid->bucket_count - 1);
+}
+
+static int item_grid_coord(float v)
+{
+	return (int)floorf(v / ITEM_GRID_CELL_SIZE);
+}
+
+/**
+ * @brief Counting sort of items by bucket.
+ */
+static void item_grid_rebuild(item_grid_t* grid, level_t* level)
+{
+	const size_t count = level->items.size;
+	size_t bucket_count = 16;
+	while (bucket_count < count * 2) {
+		bucket_count *= 2;
+	}
+	if (bucket_count != grid->bucket_count) {
+		grid->bucket_count = bucket_count;
+		grid->bucket_start = de_realloc(grid->bucket_start, (bucket_count + 1) * sizeof(*grid->bucket_start));
+	}
+	if (count > grid->entry_count) {
+		grid->entries = de_realloc(grid->entries, count * sizeof(*grid->entries));
+	}
+	grid->entry_count = count;
+
+	memset(grid->bucket_start, 0, (bucket_count + 1) * sizeof(*grid->bucket_start));
+	for (size_t i = 0; i < count; ++i) {
+		const item_t* item = level->items.data[i];
+		++grid->bucket_start[item_grid_bucket(grid, item_grid_coord(item->position.x), item_grid_coord(item->position.z)) + 1];
+	}
+	for (size_t i = 0; i < bucket_count; ++i) {
+		grid->bucket_start[i + 1] += grid->bucket_start[i];
+	}
+	/* bucket_start is used as write cursor, it ends up shifted by one bucket */
+	for (size_t i = 0; i < count; ++i) {
+		item_t* item = level->items.data[i];
+		const size_t bucket = item_grid_bucket(grid, item_grid_coord(item->position.x), item_grid_coord(item->position.z));
+		grid->entries[grid->bucket_start[bucket]++] = item;
+	}
+	for (size_t i = bucket_count; i > 0; --i) {
+		grid->bucket_start[i] = grid->bucket_start[i - 1];
+	}
+	grid->bucket_start[0] = 0;
+	grid->dirty = false;
+}
+
+void item_grid_free(item_grid_t* grid)
+{
+	if (grid->bucket_start) {
+		de_free(grid->bucket_start);
+	}
+	if (grid->entries) {
+		de_free(grid->entries);
+	}
+	memset(grid, 0, sizeof(*grid));
+}
+
+static void item_grid_pick_up_for_actor(item_grid_t* grid, actor_t* actor)
+{
+	de_vec3_t position;
+	de_node_get_global_position(actor->pivot, &position);
+	const int cx = item_grid_coord(position.x);
+	const int cz = item_grid_coord(position.z);
+	for (int z = cz - 1; z <= cz + 1; ++z) {
+		for (int x = cx - 1; x <= cx + 1; ++x) {
+			const size_t bucket = item_grid_bucket(grid, x, z);
+			for (uint32_t i = grid->bucket_start[bucket]; i < grid->bucket_start[bucket + 1]; ++i) {
+				item_t* item = grid->entries[i];
+				if (!item_is_active(item)) {
+					continue;
+				}
+				++grid->test_count;
+				const float dx = item->position.x - position.x;
+				const float dz = item->position.z - position.z;
+				if (dx * dx + dz * dz <= ITEM_PICKUP_RADIUS * ITEM_PICKUP_RADIUS && fabsf(item->position.y - position.y) <= ITEM_PICKUP_HEIGHT) {
+					item_pick_up(item, actor);
+				}
+			}
+		}
+	}
+}
+
+void item_grid_pick_up(level_t* level)
+{
+	item_grid_t* grid = &level->item_grid;
+	grid->test_count = 0;
+	if (!level->items.size) {
+		return;
+	}
+	if (grid->dirty) {
+		item_grid_rebuild(grid, level);
+	}
+	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+		item_grid_pick_up_for_actor(grid, actor);
+	}
 }
\ No newline at end of file
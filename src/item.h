@@ -19,6 +19,10 @@
 * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
 * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#define ITEM_PICKUP_RADIUS 0.5f /**< In XZ plane. */
+#define ITEM_PICKUP_HEIGHT 1.0f /**< Max vertical distance between actor and item. */
+#define ITEM_GRID_CELL_SIZE 2.0f /**< Must not be less than ITEM_PICKUP_RADIUS, only 3x3 cells are checked. */
+
 typedef enum item_type_t {
 	ITEM_TYPE_AK47,
 	ITEM_TYPE_M4,
@@ -29,7 +33,7 @@ typedef struct item_definition_t {
 	size_t max_ammo;
 	size_t pick_up_ammo;
 	float damage;
-	const char* model_path;
+	asset_id_t model;
 	int health_restore;	
 	float reactivation_time; /**< Amount of time left for item to become activated again. */
 } item_definition_t;
@@ -38,19 +42,66 @@ struct item_t {
 	item_type_t type;
 	level_t* level;
 	de_node_t* model;
-	float time_until_reactivation;
+	de_vec3_t position; /**< Copy of position of model, so pickup test does not touch scene nodes. */
+	game_timer_t reactivation_timer; /**< Scheduled while item is picked up. */
 };
 
+/**
+ * @brief Uniform grid over XZ plane for pickup tests. Cells are hashed into
+ * buckets, so grid does not depend on level size. Buckets are stored as one
+ * array of items sorted by bucket plus start index of each bucket; it is
+ * rebuilt only when items are added, moved or removed.
+ */
+typedef struct item_grid_t {
+	uint32_t* bucket_start; /**< bucket_count + 1 entries. */
+	item_t** entries;
+	size_t bucket_count; /**< Power of two. */
+	size_t entry_count;
+	bool dirty;
+	size_t test_count; /**< Distance tests made by last pickup pass. */
+} item_grid_t;
+
 const item_definition_t* item_definition_from_item_type(item_type_t type);
 
+/**
+ * @brief Parses item type from beginning of name ("Medkit", "AK47", "M4"), so
+ * names of map nodes can have any suffix. Returns false if name is unknown.
+ */
+bool item_type_from_name(const char* name, item_type_t* type);
+
 item_t* item_create(level_t* level, item_type_t type);
 
 void item_set_position(item_t* item, const de_vec3_t* pos);
 
 bool item_is_active(item_t* item);
 
+/**
+ * @brief Hides item until its reactivation time is passed.
+ */
 void item_deactivate(item_t* item);
 
+/**
+ * @brief Applies item to actor (health or ammo). Returns false if actor has no
+ * use of item, item stays active in this case.
+ */
+bool item_pick_up(item_t* item, actor_t* actor);
+
+void item_grid_free(item_grid_t* grid);
+
+/**
+ * @brief Lets every actor of level pick up active items within ITEM_PICKUP_RADIUS,
+ * only items in 3x3 cells around each actor are tested.
+ */
+void item_grid_pick_up(level_t* level);
+
 void item_free(item_t* item);
 
-void item_update(item_t* item, float dt);
\ No newline at end of file
+/**
+ * @brief Returns seconds left until picked up item becomes active again, 0 if item is active.
+ */
+float item_get_time_until_reactivation(const item_t* item);
+
+/**
+ * @brief Deactivates item for given amount of seconds, or activates it if time is 0. Used by save loading.
+ */
+void item_set_time_until_reactivation(item_t* item, float time);
\ No newline at end of file
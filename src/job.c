@@ -0,0 +1,254 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+static void job_deque_init(job_deque_t* deque)
+{
+	de_mtx_init(&deque->lock);
+	deque->top = 0;
+	deque->bottom = 0;
+}
+
+static void job_deque_deinit(job_deque_t* deque)
+{
+	de_mtx_destroy(&deque->lock);
+}
+
+static bool job_deque_push(job_deque_t* deque, const job_t* job)
+{
+	bool pushed = false;
+	de_mtx_lock(&deque->lock);
+	if (deque->bottom - deque->top < JOB_DEQUE_CAPACITY) {
+		deque->jobs[deque->bottom % JOB_DEQUE_CAPACITY] = *job;
+		++deque->bottom;
+		pushed = true;
+	}
+	de_mtx_unlock(&deque->lock);
+	return pushed;
+}
+
+/**
+ * @brief Owner side - takes most recently pushed job.
+ */
+static bool job_deque_pop(job_deque_t* deque, job_t* job)
+{
+	bool popped = false;
+	de_mtx_lock(&deque->lock);
+	if (deque->bottom != deque->top) {
+		--deque->bottom;
+		*job = deque->jobs[deque->bottom % JOB_DEQUE_CAPACITY];
+		popped = true;
+	}
+	de_mtx_unlock(&deque->lock);
+	return popped;
+}
+
+/**
+ * @brief Thief side - takes oldest job.
+ */
+static bool job_deque_steal(job_deque_t* deque, job_t* job)
+{
+	bool stolen = false;
+	de_mtx_lock(&deque->lock);
+	if (deque->bottom != deque->top) {
+		*job = deque->jobs[deque->top % JOB_DEQUE_CAPACITY];
+		++deque->top;
+		stolen = true;
+	}
+	de_mtx_unlock(&deque->lock);
+	return stolen;
+}
+
+static bool job_system_take(job_system_t* system, int thread_index, job_t* job)
+{
+	if (job_deque_pop(system->deques + thread_index, job)) {
+		return true;
+	}
+	/* own queue is empty - try to steal from others, starting from neighbour so
+	 * thieves do not fight for same victim */
+	const int thread_count = job_system_get_thread_count(system);
+	for (int i = 1; i < thread_count; ++i) {
+		if (job_deque_steal(system->deques + (thread_index + i) % thread_count, job)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void job_system_finish(job_system_t* system)
+{
+	de_mtx_lock(&system->lock);
+	DE_ASSERT(system->pending > 0);
+	if (--system->pending == 0) {
+		de_cnd_signal(&system->done);
+	}
+	de_mtx_unlock(&system->lock);
+}
+
+static void job_system_run_available(job_system_t* system, int thread_index)
+{
+	job_t job;
+	while (job_system_take(system, thread_index, &job)) {
+		job.func(job.user_data, job.begin, job.end, thread_index);
+		job_system_finish(system);
+	}
+}
+
+static int job_worker_thread(void* arg)
+{
+	job_worker_t* worker = arg;
+	job_system_t* system = worker->system;
+	uint32_t last_generation = 0;
+	for (;;) {
+		de_mtx_lock(&system->lock);
+		while (system->running && system->generation == last_generation) {
+			de_cnd_wait(&system->wake, &system->lock);
+		}
+		last_generation = system->generation;
+		const bool running = system->running;
+		de_mtx_unlock(&system->lock);
+
+		if (!running) {
+			break;
+		}
+
+		job_system_run_available(system, worker->thread_index);
+	}
+	return 0;
+}
+
+job_system_t* job_system_create(int worker_count)
+{
+	job_system_t* system = DE_NEW(job_system_t);
+	system->worker_count = worker_count > 0 ? worker_count : 0;
+	system->running = true;
+	de_mtx_init(&system->lock);
+	de_cnd_init(&system->wake);
+	de_cnd_init(&system->done);
+
+	const int thread_count = job_system_get_thread_count(system);
+	system->deques = de_calloc(thread_count, sizeof(*system->deques));
+	for (int i = 0; i < thread_count; ++i) {
+		job_deque_init(system->deques + i);
+	}
+
+	if (system->worker_count) {
+		system->workers = de_calloc(system->worker_count, sizeof(*system->workers));
+		for (int i = 0; i < system->worker_count; ++i) {
+			job_worker_t* worker = system->workers + i;
+			worker->system = system;
+			worker->thread_index = i + 1;
+			de_thread_create(&worker->thread, job_worker_thread, worker);
+		}
+	}
+
+	de_log("jobs: started %d worker threads", system->worker_count);
+
+	return system;
+}
+
+void job_system_free(job_system_t* system)
+{
+	de_mtx_lock(&system->lock);
+	system->running = false;
+	de_cnd_broadcast(&system->wake);
+	de_mtx_unlock(&system->lock);
+
+	for (int i = 0; i < system->worker_count; ++i) {
+		de_thread_join(&system->workers[i].thread);
+	}
+	if (system->workers) {
+		de_free(system->workers);
+	}
+
+	const int thread_count = job_system_get_thread_count(system);
+	for (int i = 0; i < thread_count; ++i) {
+		job_deque_deinit(system->deques + i);
+	}
+	de_free(system->deques);
+
+	de_cnd_destroy(&system->done);
+	de_cnd_destroy(&system->wake);
+	de_mtx_destroy(&system->lock);
+	de_free(system);
+}
+
+int job_system_get_thread_count(const job_system_t* system)
+{
+	return system->worker_count + 1;
+}
+
+void job_system_parallel_for(job_system_t* system, size_t count, size_t grain_size, job_func_t func, void* user_data)
+{
+	if (!count) {
+		return;
+	}
+
+	const size_t thread_count = (size_t)job_system_get_thread_count(system);
+	if (grain_size < 1) {
+		grain_size = 1;
+	}
+	/* make sure that all chunks will fit into deques */
+	const size_t min_grain_size = (count + thread_count * JOB_DEQUE_CAPACITY - 1) / (thread_count * JOB_DEQUE_CAPACITY);
+	if (grain_size < min_grain_size) {
+		grain_size = min_grain_size;
+	}
+
+	/* not worth to wake up workers */
+	if (thread_count == 1 || count <= grain_size) {
+		func(user_data, 0, count, 0);
+		return;
+	}
+
+	const size_t chunk_count = (count + grain_size - 1) / grain_size;
+
+	de_mtx_lock(&system->lock);
+	DE_ASSERT(system->pending == 0);
+	system->pending = chunk_count;
+	de_mtx_unlock(&system->lock);
+
+	/* spread chunks over all deques, so workers start with own work and steal only
+	 * when load is uneven */
+	for (size_t i = 0; i < chunk_count; ++i) {
+		job_t job;
+		job.func = func;
+		job.user_data = user_data;
+		job.begin = i * grain_size;
+		job.end = job.begin + grain_size < count ? job.begin + grain_size : count;
+		bool pushed = job_deque_push(system->deques + i % thread_count, &job);
+		DE_ASSERT(pushed);
+		DE_UNUSED(pushed);
+	}
+
+	de_mtx_lock(&system->lock);
+	++system->generation;
+	de_cnd_broadcast(&system->wake);
+	de_mtx_unlock(&system->lock);
+
+	/* main thread works too */
+	job_system_run_available(system, 0);
+
+	de_mtx_lock(&system->lock);
+	while (system->pending) {
+		de_cnd_wait(&system->done, &system->lock);
+	}
+	de_mtx_unlock(&system->lock);
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+/**
+ * @brief Job function, must process items in [begin; end) range. thread_index is
+ * 0 for main thread and 1..worker_count for workers, so jobs can use per-thread
+ * data without locks.
+ */
+typedef void(*job_func_t)(void* user_data, size_t begin, size_t end, int thread_index);
+
+typedef struct job_t {
+	job_func_t func;
+	void* user_data;
+	size_t begin;
+	size_t end;
+} job_t;
+
+#define JOB_DEQUE_CAPACITY 256
+
+/**
+ * @brief Per-thread queue. Owner pushes and pops from bottom, other threads steal
+ * from top. Protected by lock - there are no portable atomics in C99.
+ */
+typedef struct job_deque_t {
+	de_mtx_t lock;
+	job_t jobs[JOB_DEQUE_CAPACITY];
+	size_t top;
+	size_t bottom;
+} job_deque_t;
+
+typedef struct job_worker_t {
+	job_system_t* system;
+	int thread_index;
+	de_thread_t thread;
+} job_worker_t;
+
+/**
+ * @brief Fork-join work stealing scheduler. Main thread takes part in every
+ * parallel_for, so with zero workers everything runs serially on main thread.
+ */
+struct job_system_t {
+	int worker_count;
+	job_worker_t* workers;
+	job_deque_t* deques; /**< worker_count + 1 deques, 0 is main thread's one. */
+	de_mtx_t lock;
+	de_cnd_t wake;
+	de_cnd_t done;
+	size_t pending; /**< Amount of jobs of current batch that is not finished yet. */
+	uint32_t generation; /**< Incremented on each batch to wake up workers. */
+	bool running;
+};
+
+job_system_t* job_system_create(int worker_count);
+
+void job_system_free(job_system_t* system);
+
+/**
+ * @brief Returns amount of threads that can run jobs (workers + main thread).
+ */
+int job_system_get_thread_count(const job_system_t* system);
+
+/**
+ * @brief Splits [0; count) into chunks of at least grain_size items, runs func on
+ * them in parallel and returns when all chunks are done.
+ */
+void job_system_parallel_for(job_system_t* system, size_t count, size_t grain_size, job_func_t func, void* user_data);
\ No newline at end of file
@@ -22,6 +22,10 @@
 #define JUMP_PAD_TAG "JumpPad"
 #define JUMP_PAD_BEGIN_TAG "_Begin"
 #define JUMP_PAD_END_TAG "_End"
+#define PLAYER_START_TAG "PlayerPosition"
+#define ITEM_SPAWN_TAG "ItemSpawn"
+#define BOT_SPAWN_TAG "BotSpawn"
+#define NAV_CELL_SIZE 0.25f
 
 void level_create_collider(level_t* level)
 {
@@ -32,9 +36,71 @@ void level_create_collider(level_t* level)
 		map_collider = de_scene_create_static_geometry(level->scene);
 		de_node_calculate_transforms_ascending(polygon);
 		de_static_geometry_fill(map_collider, de_node_to_mesh(polygon), &polygon->global_matrix);
+		level->collider = map_collider;
+		if (level->nav) {
+			nav_grid_free(level->nav);
+		}
+		level->nav = nav_grid_create(map_collider, NAV_CELL_SIZE);
+	}
+}
+
+static size_t jump_pad_hash(const de_static_geometry_t* bounds)
+{
+	/* fibonacci hashing, low bits of pointers are always zero because of alignment */
+	return (size_t)(((uint64_t)(uintptr_t)bounds >> 4) * UINT64_C(11400714819323198485) >> 32);
+}
+
+static void jump_pad_table_insert(jump_pad_t** table, size_t table_size, jump_pad_t* pad)
+{
+	const size_t mask = table_size - 1;
+	size_t index = jump_pad_hash(pad->bounds) & mask;
+	while (table[index]) {
+		index = (index + 1) & mask;
+	}
+	table[index] = pad;
+}
+
+/**
+ * @brief Rebuilds hash table of jump pads. Keeps load factor below 0.5 so probe
+ * sequences stay short.
+ */
+static void level_rebuild_jump_pad_table(level_t* level)
+{
+	size_t table_size = 16;
+	while (table_size < level->jump_pads.size * 2) {
+		table_size *= 2;
+	}
+	if (table_size != level->jump_pad_table_size) {
+		if (level->jump_pad_table) {
+			de_free(level->jump_pad_table);
+		}
+		level->jump_pad_table = de_calloc(table_size, sizeof(*level->jump_pad_table));
+		level->jump_pad_table_size = table_size;
+	} else {
+		memset(level->jump_pad_table, 0, table_size * sizeof(*level->jump_pad_table));
+	}
+	for (size_t i = 0; i < level->jump_pads.size; ++i) {
+		jump_pad_table_insert(level->jump_pad_table, level->jump_pad_table_size, level->jump_pads.data[i]);
 	}
 }
 
+static jump_pad_t* level_find_jump_pad(const level_t* level, const de_static_geometry_t* bounds)
+{
+	if (!bounds || !level->jump_pad_table_size) {
+		return NULL;
+	}
+	const size_t mask = level->jump_pad_table_size - 1;
+	size_t index = jump_pad_hash(bounds) & mask;
+	jump_pad_t* pad;
+	while ((pad = level->jump_pad_table[index]) != NULL) {
+		if (pad->bounds == bounds) {
+			return pad;
+		}
+		index = (index + 1) & mask;
+	}
+	return NULL;
+}
+
 jump_pad_t* jump_pad_create(level_t* level, de_node_t* model, de_vec3_t force)
 {
 	jump_pad_t* pad = DE_NEW(jump_pad_t);
@@ -48,195 +114,365 @@ jump_pad_t* jump_pad_create(level_t* level, de_node_t* model, de_vec3_t force)
 	de_static_geometry_fill(pad->bounds, de_node_to_mesh(model), &transform);
 
 	DE_ARRAY_APPEND(level->jump_pads, pad);
+	if (level->jump_pads.size * 2 > level->jump_pad_table_size) {
+		level_rebuild_jump_pad_table(level);
+	} else {
+		jump_pad_table_insert(level->jump_pad_table, level->jump_pad_table_size, pad);
+	}
 	return pad;
 }
 
 void jump_pad_free(jump_pad_t* pad)
 {
-	DE_ARRAY_REMOVE(pad->level->jump_pads, pad);
+	level_t* level = pad->level;
+	DE_ARRAY_REMOVE(level->jump_pads, pad);
+	/* linear probing does not allow to just clear slot */
+	level_rebuild_jump_pad_table(level);
 	de_free(pad);
 }
 
-void jump_pad_update(jump_pad_t* pad)
+void level_free_jump_pads(level_t* level)
 {
-	level_t* level = pad->level;
+	/* no table rebuild per pad, whole table goes at once */
+	for (size_t i = 0; i < level->jump_pads.size; ++i) {
+		de_free(level->jump_pads.data[i]);
+	}
+	DE_ARRAY_CLEAR(level->jump_pads);
+	if (level->jump_pad_table) {
+		de_free(level->jump_pad_table);
+		level->jump_pad_table = NULL;
+	}
+	level->jump_pad_table_size = 0;
+}
+
+/**
+ * @brief Pushes every actor that touches a jump pad. Does single pass over contacts
+ * of actors, so cost does not depend on amount of pads on level.
+ */
+static void level_update_jump_pads(level_t* level)
+{
+	if (!level->jump_pads.size) {
+		return;
+	}
+	/* pad force is velocity per reference tick */
+	const float tick_scale = game_get_tick_scale(level->game);
 	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
 		de_body_t* body = actor->body;
-		for (size_t i = 0; i < de_body_get_contact_count(body); ++i) {
+		const size_t contact_count = de_body_get_contact_count(body);
+		for (size_t i = 0; i < contact_count; ++i) {
 			const de_contact_t* contact = de_body_get_contact(body, i);
-			if (contact->geometry == pad->bounds) {
-				de_body_set_velocity(body, &pad->force);
+			const jump_pad_t* pad = level_find_jump_pad(level, contact->geometry);
+			if (pad) {
+				de_vec3_t velocity;
+				de_vec3_scale(&velocity, &pad->force, tick_scale);
+				de_body_set_velocity(body, &velocity);
 				break;
 			}
 		}
 	}
 }
 
+static uint32_t level_node_name_hash(const char* name)
+{
+	return de_hash_murmur3((const uint8_t*)name, strlen(name), 0);
+}
+
+void level_node_index_build(level_node_index_t* index, de_scene_t* scene)
+{
+	DE_ARRAY_INIT(index->nodes);
+	for (de_node_t* node = de_scene_get_first_node(scene); node; node = de_node_get_next(node)) {
+		const char* name = de_node_get_name(node);
+		if (name && *name) {
+			DE_ARRAY_APPEND(index->nodes, node);
+		}
+	}
+
+	/* load factor is kept below 0.5 */
+	index->slots = NULL;
+	index->size = 0;
+	if (index->nodes.size) {
+		index->size = 2;
+		while (index->size < index->nodes.size * 2) {
+			index->size *= 2;
+		}
+		index->slots = de_calloc(index->size, sizeof(*index->slots));
+		const size_t mask = index->size - 1;
+		for (size_t i = 0; i < index->nodes.size; ++i) {
+			de_node_t* node = index->nodes.data[i];
+			const uint32_t hash = level_node_name_hash(de_node_get_name(node));
+			size_t slot = hash & mask;
+			while (index->slots[slot].node) {
+				slot = (slot + 1) & mask;
+			}
+			index->slots[slot].name_hash = hash;
+			index->slots[slot].node = node;
+		}
+	}
+}
+
+void level_node_index_free(level_node_index_t* index)
+{
+	if (index->slots) {
+		de_free(index->slots);
+		index->slots = NULL;
+	}
+	index->size = 0;
+	DE_ARRAY_FREE(index->nodes);
+}
+
+de_node_t* level_node_index_find(const level_node_index_t* index, const char* name)
+{
+	if (!index->size) {
+		return NULL;
+	}
+	const uint32_t hash = level_node_name_hash(name);
+	const size_t mask = index->size - 1;
+	for (size_t i = hash & mask; index->slots[i].node; i = (i + 1) & mask) {
+		const level_node_slot_t* slot = index->slots + i;
+		if (slot->name_hash == hash && strcmp(de_node_get_name(slot->node), name) == 0) {
+			return slot->node;
+		}
+	}
+	return NULL;
+}
+
+typedef void(*level_tag_handler_func_t)(level_t* level, const level_node_index_t* index, de_node_t* node, const char* name);
+
 /**
- * @brief Until we have built-in editor we'll prepare level by scanning level's scene
- * and search for nodes with special names and creating appropriate game objects
- * from them.
+ * @brief Node with name that starts with tag is passed to handler.
  */
-void level_scan_scene(level_t* level)
+typedef struct level_tag_handler_t {
+	const char* tag;
+	level_tag_handler_func_t func;
+} level_tag_handler_t;
+
+static void level_on_jump_pad(level_t* level, const level_node_index_t* index, de_node_t* node, const char* name)
 {
 	char fmt_buf[1024];
-	for (de_node_t* node = de_scene_get_first_node(level->scene); node; node = de_node_get_next(node)) {
-		const char* name = de_node_get_name(node);
-		if (name && strstr(name, JUMP_PAD_TAG)) {
-			const char* separator = strchr(name, '_');
-			if (!separator) {
-				snprintf(fmt_buf, sizeof(fmt_buf), "%s%s", name, JUMP_PAD_BEGIN_TAG);
-				de_node_t* begin = de_scene_find_node(level->scene, fmt_buf);
 
-				snprintf(fmt_buf, sizeof(fmt_buf), "%s%s", name, JUMP_PAD_END_TAG);
-				de_node_t* end = de_scene_find_node(level->scene, fmt_buf);
+	/* JumpPadN_Begin and JumpPadN_End are markers of pad JumpPadN */
+	if (strchr(name, '_')) {
+		return;
+	}
 
-				if (begin && end) {
-					de_vec3_t begin_pos;
-					de_node_get_global_position(begin, &begin_pos);
+	snprintf(fmt_buf, sizeof(fmt_buf), "%s%s", name, JUMP_PAD_BEGIN_TAG);
+	de_node_t* begin = level_node_index_find(index, fmt_buf);
 
-					de_vec3_t end_pos;
-					de_node_get_global_position(end, &end_pos);
+	snprintf(fmt_buf, sizeof(fmt_buf), "%s%s", name, JUMP_PAD_END_TAG);
+	de_node_t* end = level_node_index_find(index, fmt_buf);
 
-					de_vec3_t force;
-					de_vec3_sub(&force, &end_pos, &begin_pos);
+	if (begin && end) {
+		de_vec3_t begin_pos;
+		de_node_get_global_position(begin, &begin_pos);
 
-					float length;
-					de_vec3_normalize_ex(&force, &force, &length);
-					
-					de_vec3_scale(&force, &force, length / 20.0f);
+		de_vec3_t end_pos;
+		de_node_get_global_position(end, &end_pos);
 
-					jump_pad_create(level, node, force);
-				}
-			}
-		}
+		de_vec3_t force;
+		de_vec3_sub(&force, &end_pos, &begin_pos);
+
+		float length;
+		de_vec3_normalize_ex(&force, &force, &length);
+		
+		de_vec3_scale(&force, &force, length / 20.0f);
+
+		jump_pad_create(level, node, force);
 	}
 }
 
-bool level_visit(de_object_visitor_t* visitor, level_t* level)
+static void level_on_player_start(level_t* level, const level_node_index_t* index, de_node_t* node, const char* name)
 {
-	bool result = true;
-	if (visitor->is_reading) {
-		level->game = de_core_get_user_pointer(visitor->core);
-	}
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "Scene", &level->scene, de_scene_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_INTRUSIVE_LINKED_LIST(visitor, "Actors", level->actors, actor_t, actor_visit);
+	DE_UNUSED(index);
+	DE_UNUSED(name);
+	de_node_get_global_position(node, &level->player_start);
+	level->has_player_start = true;
+}
 
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "Player", &level->player, actor_visit);
-	if (visitor->is_reading) {
-		level_create_collider(level);
-		level_scan_scene(level);
+static void level_on_item_spawn(level_t* level, const level_node_index_t* index, de_node_t* node, const char* name)
+{
+	DE_UNUSED(index);
+	/* ItemSpawn_<ItemName><anything> */
+	level_item_spawn_t spawn;
+	if (name[strlen(ITEM_SPAWN_TAG)] != '_' || !item_type_from_name(name + strlen(ITEM_SPAWN_TAG) + 1, &spawn.type)) {
+		de_log("level: unknown item in spawn %s", name);
+		return;
 	}
-	return result;
+	de_node_get_global_position(node, &spawn.position);
+	DE_ARRAY_APPEND(level->item_spawns, spawn);
 }
 
-level_t* level_create_test(game_t* game)
+static void level_on_bot_spawn(level_t* level, const level_node_index_t* index, de_node_t* node, const char* name)
 {
-	level_t* level = DE_NEW(level_t);
-	level->game = game;
-	level->scene = de_scene_create(game->core);
-	footstep_sound_map_read(game->core, &level->footstep_sound_map);
+	DE_UNUSED(index);
+	DE_UNUSED(name);
+	de_vec3_t position;
+	de_node_get_global_position(node, &position);
+	DE_ARRAY_APPEND(level->bot_spawns, position);
+}
 
-	de_path_t res_path;
-	de_path_init(&res_path);
+static const level_tag_handler_t level_tag_handlers[] = {
+	{ JUMP_PAD_TAG, level_on_jump_pad },
+	{ PLAYER_START_TAG, level_on_player_start },
+	{ ITEM_SPAWN_TAG, level_on_item_spawn },
+	{ BOT_SPAWN_TAG, level_on_bot_spawn },
+};
 
-	actor_t* bot = actor_create(level, ACTOR_TYPE_BOT);
-	actor_set_position(bot, &(de_vec3_t){-1.0, 0.0, -1.0});
+/**
+ * @brief Until we have built-in editor we'll prepare level by scanning level's scene
+ * and search for nodes with special names and creating appropriate game objects
+ * from them. Scene is walked once, related nodes are found through name index.
+ */
+void level_scan_scene(level_t* level)
+{
+	level_node_index_t index;
+	level_node_index_build(&index, level->scene);
 
-	item_t* medkit = item_create(level, ITEM_TYPE_MEDKIT);
-	item_set_position(medkit, &(de_vec3_t){0.0f, 0.1f, 0.0f});
+	for (size_t i = 0; i < index.nodes.size; ++i) {
+		de_node_t* node = index.nodes.data[i];
+		const char* name = de_node_get_name(node);
+		for (size_t k = 0; k < DE_ARRAY_SIZE(level_tag_handlers); ++k) {
+			const level_tag_handler_t* handler = level_tag_handlers + k;
+			if (strncmp(name, handler->tag, strlen(handler->tag)) == 0) {
+				handler->func(level, &index, node, name);
+				break;
+			}
+		}
+	}
 
-	/* Ripper */
-	de_path_append_cstr(&res_path, "data/models/ripper.fbx");
-	de_resource_t* res = de_core_request_resource(game->core, DE_RESOURCE_TYPE_MODEL, &res_path);
-	de_model_t* mdl = de_resource_to_model(res);
-	de_node_t* ripper1 = de_model_instantiate(mdl, level->scene);
-	de_node_set_local_position(ripper1, &(de_vec3_t){ -1, 0, -1 });
-	de_node_t* ripper2 = de_model_instantiate(mdl, level->scene);
-	de_node_set_local_position(ripper2, &(de_vec3_t){ 1, 0, -1 });
-	de_node_t* ripper3 = de_model_instantiate(mdl, level->scene);
-	de_node_set_local_position(ripper3, &(de_vec3_t){ 1, 0, 1 });
-	de_node_t* ripper4 = de_model_instantiate(mdl, level->scene);
-	de_node_set_local_position(ripper4, &(de_vec3_t){ -1, 0, 1 });
+	level_node_index_free(&index);
+}
 
-	/* Level */
-	de_path_clear(&res_path);
-	de_path_append_cstr(&res_path, "data/models/dm6.fbx");
-	res = de_core_request_resource(game->core, DE_RESOURCE_TYPE_MODEL, &res_path);
-	de_model_instantiate(de_resource_to_model(res), level->scene);
+level_t* level_create(game_t* game, const char* map_path)
+{
+	level_loader_t* loader = level_loader_create(game, map_path, false);
+	level_loader_update(loader, INFINITY);
+	return level_loader_finish(loader);
+}
 
-	level_create_collider(level);
+level_t* level_create_test(game_t* game)
+{
+	level_loader_t* loader = level_loader_create(game, LEVEL_TEST_MAP_PATH, true);
+	level_loader_update(loader, INFINITY);
+	return level_loader_finish(loader);
+}
 
-	level_scan_scene(level);
+void level_update(level_t* level)
+{
+	profiler_t* profiler = level->game->profiler;
 
-	de_node_t* particle_system_node = de_node_create(level->scene, DE_NODE_TYPE_PARTICLE_SYSTEM);
-	de_particle_system_t* particle_system = de_node_to_particle_system(particle_system_node);
-	de_particle_system_emitter_t* emitter = de_particle_system_emitter_create(particle_system, DE_PARTICLE_SYSTEM_EMITTER_TYPE_SPHERE);
-	emitter->max_particles = 1000;
-	emitter->particle_spawn_rate = 50;
-	particle_system->acceleration.y = -0.1f;
-	de_color_gradient_t* gradient = de_particle_system_get_color_gradient_over_lifetime(particle_system);
-	de_color_gradient_add_point(gradient, 0.00f, &(de_color_t) { 150, 150, 150, 0 });
-	de_color_gradient_add_point(gradient, 0.05f, &(de_color_t) { 150, 150, 150, 220 });
-	de_color_gradient_add_point(gradient, 0.85f, &(de_color_t) { 255, 255, 255, 180 });
-	de_color_gradient_add_point(gradient, 1.00f, &(de_color_t) { 255, 255, 255, 0 });
-	de_path_clear(&res_path);
-	de_path_append_cstr(&res_path, "data/particles/smoke_04.tga");
-	res = de_core_request_resource(game->core, DE_RESOURCE_TYPE_TEXTURE, &res_path);
-	de_particle_system_set_texture(particle_system, de_resource_to_texture(res));
+	timer_wheel_tick(&level->timers);
 
-	de_path_free(&res_path);
+	profiler_begin_scope(profiler, PROFILER_SCOPE_LEVEL_ITEMS);
+	item_grid_pick_up(level);
+	profiler_end_scope(profiler, PROFILER_SCOPE_LEVEL_ITEMS);
 
-	level->player = actor_create(level, ACTOR_TYPE_PLAYER);
-	de_node_t* pp = de_scene_find_node(level->scene, "PlayerPosition");
-	if (pp) {
-		de_vec3_t pos;
-		de_node_get_global_position(pp, &pos);
-		actor_set_position(level->player, &pos);
+	profiler_begin_scope(profiler, PROFILER_SCOPE_LEVEL_ACTORS);
+	if (level->player) {
+		actor_update(level->player);
 	}
+	bot_update_batch(level);
+	profiler_end_scope(profiler, PROFILER_SCOPE_LEVEL_ACTORS);
+
+	profiler_begin_scope(profiler, PROFILER_SCOPE_LEVEL_HITSCAN);
+	hitscan_resolve(&level->hitscan, level);
+	profiler_end_scope(profiler, PROFILER_SCOPE_LEVEL_HITSCAN);
 
-	return level;
+	profiler_begin_scope(profiler, PROFILER_SCOPE_LEVEL_PROJECTILES);
+	for (projectile_t* projectile = level->projectiles.head; projectile; projectile = projectile->next) {
+		projectile_update(projectile);
+	}
+	profiler_end_scope(profiler, PROFILER_SCOPE_LEVEL_PROJECTILES);
+
+	profiler_begin_scope(profiler, PROFILER_SCOPE_LEVEL_JUMP_PADS);
+	level_update_jump_pads(level);
+	profiler_end_scope(profiler, PROFILER_SCOPE_LEVEL_JUMP_PADS);
 }
 
-void level_update(level_t* level, float dt)
+static void level_add_body_state(level_t* level, de_body_t* body)
 {
-	for(size_t i = 0; i < level->items.size; ++i) {
-		item_update(level->items.data[i], dt);
-	}
+	level_body_state_t state;
+	state.body = body;
+	state.previous = body->position;
+	state.current = body->position;
+	DE_ARRAY_APPEND(level->body_states, state);
+}
 
+void level_store_body_positions(level_t* level)
+{
+	/* list is rebuilt every tick, so spawned, freed or teleported actors and projectiles
+	 * never interpolate from stale positions */
+	DE_ARRAY_CLEAR(level->body_states);
 	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
-		actor_update(actor);
+		level_add_body_state(level, actor->body);
 	}
-
 	for (projectile_t* projectile = level->projectiles.head; projectile; projectile = projectile->next) {
-		projectile_update(projectile);
+		if (projectile->body) {
+			level_add_body_state(level, projectile->body);
+		}
 	}
+}
 
-	for (size_t i = 0; i < level->jump_pads.size; ++i) {
-		jump_pad_update(level->jump_pads.data[i]);
+void level_interpolate_body_positions(level_t* level, float alpha)
+{
+	if (!level->body_states.size) {
+		return;
+	}
+	for (size_t i = 0; i < level->body_states.size; ++i) {
+		level_body_state_t* state = &level->body_states.data[i];
+		state->current = state->body->position;
+		de_vec3_t position;
+		de_vec3_lerp(&position, &state->previous, &state->current, alpha);
+		de_body_set_position(state->body, &position);
+	}
+	/* zero step only syncs nodes with bodies and recalculates transforms */
+	de_scene_update(level->scene, 0.0);
+}
+
+void level_restore_body_positions(level_t* level)
+{
+	for (size_t i = 0; i < level->body_states.size; ++i) {
+		level_body_state_t* state = &level->body_states.data[i];
+		de_body_set_position(state->body, &state->current);
 	}
 }
 
 void level_free(level_t* level)
 {
 	/* free jump pads */
-	while (level->jump_pads.size) {
-		jump_pad_free(DE_ARRAY_LAST(level->jump_pads));
-	}
+	level_free_jump_pads(level);
 	DE_ARRAY_FREE(level->jump_pads);
 
 	/* free actors */
 	while (level->actors.head) {
 		actor_free(level->actors.head);
 	}
+	for (size_t i = 0; i < ACTOR_TYPE_COUNT; ++i) {
+		actor_pool_free(&level->actor_pools[i]);
+	}
+	DE_ARRAY_FREE(level->bots);
+	if (level->bot_commands) {
+		de_free(level->bot_commands);
+	}
+	if (level->nav) {
+		nav_grid_free(level->nav);
+	}
+	hitscan_deinit(&level->hitscan);
+	DE_ARRAY_FREE(level->body_states);
 
 	/* free items */
 	while(level->items.size) {
 		item_free(DE_ARRAY_LAST(level->items));
 	}
 	DE_ARRAY_FREE(level->items);
+	item_grid_free(&level->item_grid);
+	DE_ARRAY_FREE(level->item_spawns);
+	DE_ARRAY_FREE(level->bot_spawns);
+
+	/* before scene, nodes of projectiles belong to it */
+	projectile_pool_free(level);
 
 	footstep_sound_map_free(&level->footstep_sound_map);	
 	de_scene_free(level->scene);
+	asset_registry_deinit(&level->assets);
 	de_free(level);
 }
\ No newline at end of file
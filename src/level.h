@@ -19,6 +19,9 @@
 * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
 * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#define LEVEL_MAP_PATH_MAX 256
+#define LEVEL_TEST_MAP_PATH "data/models/dm6.fbx"
+
 typedef struct jump_pad_t {
 	level_t* level;
 	de_node_t* model;
@@ -26,23 +29,125 @@ typedef struct jump_pad_t {
 	de_static_geometry_t* bounds;
 } jump_pad_t;
 
+/**
+ * @brief Item spawn point found on map ("ItemSpawn_<ItemName>" node).
+ */
+typedef struct level_item_spawn_t {
+	item_type_t type;
+	de_vec3_t position;
+} level_item_spawn_t;
+
+/**
+ * @brief Position of moving body before and after last physics step, rendering
+ * interpolates between them.
+ */
+typedef struct level_body_state_t {
+	de_body_t* body;
+	de_vec3_t previous;
+	de_vec3_t current;
+} level_body_state_t;
+
+typedef struct level_node_slot_t {
+	uint32_t name_hash;
+	de_node_t* node; /**< NULL if slot is empty. */
+} level_node_slot_t;
+
+/**
+ * @brief Open-addressed hash table of named nodes of scene, built with one walk over
+ * scene so related nodes (like begin and end of jump pad) or nodes referenced by
+ * level cache are found in O(1) instead of walking whole scene with de_scene_find_node.
+ */
+typedef struct level_node_index_t {
+	DE_ARRAY_DECLARE(de_node_t*, nodes); /**< Named nodes in scene order. */
+	level_node_slot_t* slots;
+	size_t size; /**< Always power of two. */
+} level_node_index_t;
+
 struct level_t {
 	game_t* game;
 	de_scene_t* scene;
+	char map_path[LEVEL_MAP_PATH_MAX]; /**< Model of map, saved so map can be re-instantiated on load */
 	actor_t* player;
 	footstep_sound_map_t footstep_sound_map;
 	DE_ARRAY_DECLARE(jump_pad_t*, jump_pads);
+	/* open-addressed hash table of jump pads keyed by pad->bounds, so contacts of
+	 * actors can be mapped to pads in O(1); size is always power of two */
+	jump_pad_t** jump_pad_table;
+	size_t jump_pad_table_size;
+	timer_wheel_t timers; /**< Delayed events of level (item reactivation, projectile expiry), ticked by level_update */
 	DE_ARRAY_DECLARE(item_t*, items);
+	item_grid_t item_grid; /**< Spatial index of items for pickup tests */
 	DE_LINKED_LIST_DECLARE(struct projectile_t, projectiles);
+	projectile_pool_t projectile_pool;
 	DE_LINKED_LIST_DECLARE(struct actor_t, actors);
+	actor_pool_t actor_pools[ACTOR_TYPE_COUNT];
+	DE_ARRAY_DECLARE(actor_t*, bots); /**< Packed batch of bots, updated in one pass */
+	bot_command_t* bot_commands; /**< One command per bot, filled by parallel thinking */
+	size_t bot_command_capacity;
+	de_static_geometry_t* collider; /**< Static geometry of map, NULL if map has no "Polygon" mesh */
+	nav_grid_t* nav; /**< Built from collider, NULL if level has no collider */
+	de_vec3_t player_start; /**< Position of "PlayerPosition" node */
+	bool has_player_start;
+	DE_ARRAY_DECLARE(level_item_spawn_t, item_spawns);
+	DE_ARRAY_DECLARE(de_vec3_t, bot_spawns); /**< Positions of "BotSpawn" nodes */
+	hitscan_t hitscan; /**< Shots of current tick, resolved after actors are updated */
+	asset_registry_t assets; /**< Models and sounds of actors, weapons, items and projectiles */
+	DE_ARRAY_DECLARE(level_body_state_t, body_states); /**< Bodies of actors and projectiles, rebuilt each tick */
 };
 
+jump_pad_t* jump_pad_create(level_t* level, de_node_t* model, de_vec3_t force);
+
+/**
+ * @brief Frees single jump pad, hash table of pads is rebuilt.
+ */
+void jump_pad_free(jump_pad_t* pad);
+
+/**
+ * @brief Frees every jump pad of level and their hash table in one pass.
+ */
+void level_free_jump_pads(level_t* level);
+
+void level_node_index_build(level_node_index_t* index, de_scene_t* scene);
+
+void level_node_index_free(level_node_index_t* index);
+
+/**
+ * @brief Returns node with exact name or NULL.
+ */
+de_node_t* level_node_index_find(const level_node_index_t* index, const char* name);
+
 void level_create_collider(level_t* level);
 
-bool level_visit(de_object_visitor_t* visitor, level_t* level);
+/**
+ * @brief Creates jump pads and collects player start and spawn points from tagged nodes of scene.
+ */
+void level_scan_scene(level_t* level);
+
+/**
+ * @brief Creates level with map and static decorations, but without actors and items.
+ */
+level_t* level_create(game_t* game, const char* map_path);
 
 level_t* level_create_test(game_t* game);
 
-void level_update(level_t* level, float dt);
+void level_update(level_t* level);
+
+/**
+ * @brief Remembers positions of bodies of actors and projectiles, must be called right
+ * before physics step.
+ */
+void level_store_body_positions(level_t* level);
+
+/**
+ * @brief Moves bodies of actors and projectiles (and nodes attached to them) between
+ * positions before and after last physics step. Must be followed by
+ * level_restore_body_positions once frame is rendered.
+ */
+void level_interpolate_body_positions(level_t* level, float alpha);
+
+/**
+ * @brief Puts bodies back to simulated positions, so interpolation never affects simulation.
+ */
+void level_restore_body_positions(level_t* level);
 
 void level_free(level_t* level);
\ No newline at end of file
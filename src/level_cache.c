@@ -0,0 +1,305 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+void level_cache_get_path(const level_t* level, char* path, size_t size)
+{
+	snprintf(path, size, "%s%s", level->map_path, LEVEL_CACHE_EXTENSION);
+}
+
+/**
+ * @brief Computes size and FNV-1a hash of map file, cache is valid only for exact same map.
+ */
+static bool level_cache_hash_map(const level_t* level, uint32_t* size, uint32_t* hash)
+{
+	FILE* file = fopen(level->map_path, "rb");
+	if (!file) {
+		return false;
+	}
+	uint8_t chunk[16 * 1024];
+	uint32_t h = 2166136261u;
+	size_t total = 0;
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+		for (size_t i = 0; i < n; ++i) {
+			h = (h ^ chunk[i]) * 16777619u;
+		}
+		total += n;
+	}
+	fclose(file);
+	*size = (uint32_t)total;
+	*hash = h;
+	return true;
+}
+
+static void level_cache_write_collider(const level_t* level, savegame_buffer_t* buffer)
+{
+	const de_static_geometry_t* collider = level->collider;
+	const uint32_t count = collider ? (uint32_t)collider->triangles.size : 0;
+	savegame_write_u32(buffer, count);
+	for (uint32_t i = 0; i < count; ++i) {
+		const de_static_triangle_t* triangle = collider->triangles.data + i;
+		savegame_write_vec3(buffer, &triangle->a);
+		savegame_write_vec3(buffer, &triangle->b);
+		savegame_write_vec3(buffer, &triangle->c);
+		savegame_write_u32(buffer, triangle->material_hash);
+	}
+}
+
+static void level_cache_write_nav(const level_t* level, savegame_buffer_t* buffer)
+{
+	const nav_grid_t* nav = level->nav;
+	savegame_write_u32(buffer, nav ? 1 : 0);
+	if (!nav) {
+		return;
+	}
+	savegame_write_vec3(buffer, &nav->origin);
+	savegame_write_f32(buffer, nav->cell_size);
+	savegame_write_u32(buffer, (uint32_t)nav->width);
+	savegame_write_u32(buffer, (uint32_t)nav->depth);
+	const size_t cell_count = (size_t)nav->width * (size_t)nav->depth;
+	for (size_t i = 0; i < cell_count; ++i) {
+		const nav_cell_t* cell = nav->cells + i;
+		for (int k = 0; k < NAV_MAX_LAYERS; ++k) {
+			savegame_write_f32(buffer, cell->floor[k]);
+		}
+		savegame_write_bytes(buffer, &cell->layer_count, 1);
+		savegame_write_bytes(buffer, &cell->blocked_mask, 1);
+	}
+}
+
+static void level_cache_write_jump_pads(const level_t* level, savegame_buffer_t* buffer)
+{
+	savegame_write_u32(buffer, (uint32_t)level->jump_pads.size);
+	for (size_t i = 0; i < level->jump_pads.size; ++i) {
+		const jump_pad_t* pad = level->jump_pads.data[i];
+		savegame_write_string(buffer, de_node_get_name(pad->model));
+		savegame_write_vec3(buffer, &pad->force);
+	}
+}
+
+static void level_cache_write_spawns(const level_t* level, savegame_buffer_t* buffer)
+{
+	savegame_write_u32(buffer, (uint32_t)level->item_spawns.size);
+	for (size_t i = 0; i < level->item_spawns.size; ++i) {
+		savegame_write_u32(buffer, (uint32_t)level->item_spawns.data[i].type);
+		savegame_write_vec3(buffer, &level->item_spawns.data[i].position);
+	}
+	savegame_write_u32(buffer, (uint32_t)level->bot_spawns.size);
+	for (size_t i = 0; i < level->bot_spawns.size; ++i) {
+		savegame_write_vec3(buffer, &level->bot_spawns.data[i]);
+	}
+}
+
+bool level_cache_save(level_t* level)
+{
+	uint32_t map_size, map_hash;
+	if (!level_cache_hash_map(level, &map_size, &map_hash)) {
+		return false;
+	}
+
+	savegame_buffer_t buffer;
+	savegame_buffer_init(&buffer);
+	savegame_write_u32(&buffer, LEVEL_CACHE_MAGIC);
+	savegame_write_u32(&buffer, LEVEL_CACHE_VERSION);
+	savegame_write_u32(&buffer, map_size);
+	savegame_write_u32(&buffer, map_hash);
+	level_cache_write_collider(level, &buffer);
+	level_cache_write_nav(level, &buffer);
+	level_cache_write_jump_pads(level, &buffer);
+	savegame_write_u32(&buffer, level->has_player_start ? 1 : 0);
+	savegame_write_vec3(&buffer, &level->player_start);
+	level_cache_write_spawns(level, &buffer);
+
+	char path[LEVEL_CACHE_PATH_MAX];
+	level_cache_get_path(level, path, sizeof(path));
+	bool result = false;
+	FILE* file = fopen(path, "wb");
+	if (file) {
+		result = fwrite(buffer.data, 1, buffer.size, file) == buffer.size;
+		fclose(file);
+	}
+	if (!result) {
+		de_log("level cache: unable to write %s", path);
+	}
+	savegame_buffer_free(&buffer);
+	return result;
+}
+
+static void level_cache_read_collider(level_t* level, savegame_buffer_t* buffer)
+{
+	const uint32_t count = savegame_read_u32(buffer);
+	/* each triangle takes 40 bytes, do not trust count from damaged file */
+	if (count > (buffer->size - buffer->read_pos) / 40) {
+		buffer->read_error = true;
+		return;
+	}
+	if (!count) {
+		return;
+	}
+	level->collider = de_scene_create_static_geometry(level->scene);
+	for (uint32_t i = 0; i < count; ++i) {
+		de_vec3_t a, b, c;
+		savegame_read_vec3(buffer, &a);
+		savegame_read_vec3(buffer, &b);
+		savegame_read_vec3(buffer, &c);
+		const uint32_t material_hash = savegame_read_u32(buffer);
+		de_static_geometry_add_triangle(level->collider, &a, &b, &c, material_hash);
+	}
+}
+
+static void level_cache_read_nav(level_t* level, savegame_buffer_t* buffer)
+{
+	if (!savegame_read_u32(buffer)) {
+		return;
+	}
+	de_vec3_t origin;
+	savegame_read_vec3(buffer, &origin);
+	const float cell_size = savegame_read_f32(buffer);
+	const uint32_t width = savegame_read_u32(buffer);
+	const uint32_t depth = savegame_read_u32(buffer);
+	/* each cell takes 18 bytes */
+	if (buffer->read_error || (uint64_t)width * depth > (buffer->size - buffer->read_pos) / 18) {
+		buffer->read_error = true;
+		return;
+	}
+	level->nav = nav_grid_create_with_size(&origin, cell_size, (int)width, (int)depth);
+	const size_t cell_count = (size_t)width * (size_t)depth;
+	for (size_t i = 0; i < cell_count; ++i) {
+		nav_cell_t* cell = level->nav->cells + i;
+		for (int k = 0; k < NAV_MAX_LAYERS; ++k) {
+			cell->floor[k] = savegame_read_f32(buffer);
+		}
+		savegame_read_bytes(buffer, &cell->layer_count, 1);
+		savegame_read_bytes(buffer, &cell->blocked_mask, 1);
+		if (cell->layer_count > NAV_MAX_LAYERS) {
+			buffer->read_error = true;
+			return;
+		}
+	}
+}
+
+static void level_cache_read_jump_pads(level_t* level, savegame_buffer_t* buffer)
+{
+	const uint32_t count = savegame_read_u32(buffer);
+	if (buffer->read_error || !count) {
+		return;
+	}
+	/* one walk over scene instead of one per pad */
+	level_node_index_t index;
+	level_node_index_build(&index, level->scene);
+	for (uint32_t i = 0; i < count && !buffer->read_error; ++i) {
+		char name[1024];
+		de_vec3_t force;
+		savegame_read_string(buffer, name, sizeof(name));
+		savegame_read_vec3(buffer, &force);
+		de_node_t* node = buffer->read_error ? NULL : level_node_index_find(&index, name);
+		if (!node) {
+			/* map does not match cache */
+			buffer->read_error = true;
+			break;
+		}
+		jump_pad_create(level, node, force);
+	}
+	level_node_index_free(&index);
+}
+
+static void level_cache_read_spawns(level_t* level, savegame_buffer_t* buffer)
+{
+	const uint32_t item_count = savegame_read_u32(buffer);
+	for (uint32_t i = 0; i < item_count && !buffer->read_error; ++i) {
+		level_item_spawn_t spawn;
+		spawn.type = (item_type_t)savegame_read_u32(buffer);
+		savegame_read_vec3(buffer, &spawn.position);
+		if (!item_definition_from_item_type(spawn.type)) {
+			buffer->read_error = true;
+			return;
+		}
+		DE_ARRAY_APPEND(level->item_spawns, spawn);
+	}
+	const uint32_t bot_count = savegame_read_u32(buffer);
+	for (uint32_t i = 0; i < bot_count && !buffer->read_error; ++i) {
+		de_vec3_t position;
+		savegame_read_vec3(buffer, &position);
+		DE_ARRAY_APPEND(level->bot_spawns, position);
+	}
+}
+
+/**
+ * @brief Reverts partially read cache.
+ */
+static void level_cache_rollback(level_t* level)
+{
+	level_free_jump_pads(level);
+	if (level->nav) {
+		nav_grid_free(level->nav);
+		level->nav = NULL;
+	}
+	if (level->collider) {
+		de_scene_free_static_geometry(level->scene, level->collider);
+		level->collider = NULL;
+	}
+	level->has_player_start = false;
+	DE_ARRAY_CLEAR(level->item_spawns);
+	DE_ARRAY_CLEAR(level->bot_spawns);
+}
+
+bool level_cache_load(level_t* level)
+{
+	DE_ASSERT(!level->collider && !level->nav && !level->jump_pads.size);
+
+	char path[LEVEL_CACHE_PATH_MAX];
+	level_cache_get_path(level, path, sizeof(path));
+	savegame_buffer_t buffer;
+	savegame_buffer_init(&buffer);
+	if (!savegame_buffer_read_file(path, &buffer)) {
+		savegame_buffer_free(&buffer);
+		return false;
+	}
+
+	bool result = false;
+	uint32_t map_size, map_hash;
+	const uint32_t magic = savegame_read_u32(&buffer);
+	const uint32_t version = savegame_read_u32(&buffer);
+	const uint32_t cached_map_size = savegame_read_u32(&buffer);
+	const uint32_t cached_map_hash = savegame_read_u32(&buffer);
+	if (buffer.read_error || magic != LEVEL_CACHE_MAGIC || version != LEVEL_CACHE_VERSION) {
+		de_log("level cache: %s is not valid cache file", path);
+	} else if (!level_cache_hash_map(level, &map_size, &map_hash) || map_size != cached_map_size || map_hash != cached_map_hash) {
+		de_log("level cache: %s is outdated", path);
+	} else {
+		level_cache_read_collider(level, &buffer);
+		level_cache_read_nav(level, &buffer);
+		level_cache_read_jump_pads(level, &buffer);
+		level->has_player_start = savegame_read_u32(&buffer) != 0;
+		savegame_read_vec3(&buffer, &level->player_start);
+		level_cache_read_spawns(level, &buffer);
+		if (buffer.read_error) {
+			de_log("level cache: %s is damaged", path);
+			level_cache_rollback(level);
+		} else {
+			result = true;
+		}
+	}
+
+	savegame_buffer_free(&buffer);
+	return result;
+}
\ No newline at end of file
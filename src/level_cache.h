@@ -0,0 +1,52 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+/* Level cache is written next to map on first load of map and contains everything
+ * that is derived from map by game code (layout is same as in save files):
+ *   header: magic, version, size and FNV-1a hash of map file (uint32 each)
+ *   collider: triangle count, then a, b, c and material hash of each triangle
+ *   nav grid: origin, cell size, width, depth, then floors, layer count and blocked
+ *   mask of each cell
+ *   jump pads: count, then node name and force of each pad
+ *   player start: flag and position
+ *   spawns: item spawn count, type and position of each, bot spawn count, position of each
+ * Map model itself is still loaded from FBX, its meshes are needed for rendering.
+ * Cache is rebuilt when map file changes. */
+
+#define LEVEL_CACHE_MAGIC 0x434C4853u /* "SHLC" */
+#define LEVEL_CACHE_VERSION 4u
+#define LEVEL_CACHE_EXTENSION ".cache"
+#define LEVEL_CACHE_PATH_MAX (LEVEL_MAP_PATH_MAX + sizeof(LEVEL_CACHE_EXTENSION))
+
+void level_cache_get_path(const level_t* level, char* path, size_t size);
+
+/**
+ * @brief Restores collider, nav grid, jump pads, player start and spawns from cache of map
+ * of level. Map model must be already instantiated. Returns false if there is no
+ * cache or it is outdated or damaged, level is left untouched in this case.
+ */
+bool level_cache_load(level_t* level);
+
+/**
+ * @brief Writes cache for collider, nav grid, jump pads, player start and spawns of level.
+ */
+bool level_cache_save(level_t* level);
\ No newline at end of file
@@ -0,0 +1,305 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+#define LEVEL_LOADER_RIPPER_PATH "data/models/ripper.fbx"
+#define LEVEL_LOADER_SMOKE_PATH "data/particles/smoke_04.tga"
+
+/* relative cost of stages, used only for progress */
+static const int level_load_stage_weights[LEVEL_LOAD_STAGE_DONE] = {
+	[LEVEL_LOAD_STAGE_ASSETS] = 1, /* per asset */
+	[LEVEL_LOAD_STAGE_FOOTSTEPS] = 4,
+	[LEVEL_LOAD_STAGE_DECORATIONS] = 2,
+	[LEVEL_LOAD_STAGE_MAP] = 12,
+	[LEVEL_LOAD_STAGE_MAP_INSTANCE] = 4,
+	[LEVEL_LOAD_STAGE_COLLIDER] = 6,
+	[LEVEL_LOAD_STAGE_ENTITIES] = 1,
+	[LEVEL_LOAD_STAGE_EFFECTS] = 1,
+	[LEVEL_LOAD_STAGE_POPULATE] = 1,
+};
+
+static int level_prefetch_thread(void* arg)
+{
+	level_loader_t* loader = arg;
+	const size_t chunk_size = 64 * 1024;
+	char* chunk = de_malloc(chunk_size);
+	for (size_t i = 0; i < loader->prefetch_count; ++i) {
+		de_mtx_lock(&loader->lock);
+		const bool cancelled = loader->cancelled;
+		de_mtx_unlock(&loader->lock);
+		if (cancelled) {
+			break;
+		}
+
+		size_t size = 0;
+		FILE* file = fopen(loader->prefetch_paths[i], "rb");
+		if (file) {
+			size_t n;
+			while ((n = fread(chunk, 1, chunk_size, file)) > 0) {
+				size += n;
+			}
+			fclose(file);
+		}
+
+		de_mtx_lock(&loader->lock);
+		++loader->prefetched_count;
+		loader->prefetched_bytes += size;
+		de_mtx_unlock(&loader->lock);
+	}
+	de_free(chunk);
+	return 0;
+}
+
+static void level_loader_add_prefetch(level_loader_t* loader, const char* path)
+{
+	if (loader->prefetch_count < LEVEL_LOADER_MAX_PREFETCH_FILES) {
+		loader->prefetch_paths[loader->prefetch_count++] = path;
+	}
+}
+
+static de_model_t* level_loader_request_model(level_loader_t* loader, const char* path)
+{
+	de_path_t res_path;
+	de_path_from_cstr_as_view(&res_path, path);
+	de_resource_t* res = de_core_request_resource(loader->game->core, DE_RESOURCE_TYPE_MODEL, &res_path);
+	return res ? de_resource_to_model(res) : NULL;
+}
+
+#ifndef SHOOTER_DEDICATED_SERVER
+static void level_loader_create_decorations(level_loader_t* loader)
+{
+	de_model_t* mdl = level_loader_request_model(loader, LEVEL_LOADER_RIPPER_PATH);
+	if (!mdl) {
+		return;
+	}
+	static const de_vec3_t positions[] = { { -1, 0, -1 }, { 1, 0, -1 }, { 1, 0, 1 }, { -1, 0, 1 } };
+	for (size_t i = 0; i < DE_ARRAY_SIZE(positions); ++i) {
+		de_node_t* ripper = de_model_instantiate(mdl, loader->level->scene);
+		de_node_set_local_position(ripper, &positions[i]);
+	}
+}
+
+static void level_loader_create_effects(level_loader_t* loader)
+{
+	level_t* level = loader->level;
+	de_node_t* particle_system_node = de_node_create(level->scene, DE_NODE_TYPE_PARTICLE_SYSTEM);
+	de_particle_system_t* particle_system = de_node_to_particle_system(particle_system_node);
+	de_particle_system_emitter_t* emitter = de_particle_system_emitter_create(particle_system, DE_PARTICLE_SYSTEM_EMITTER_TYPE_SPHERE);
+	emitter->max_particles = 1000;
+	emitter->particle_spawn_rate = 50;
+	particle_system->acceleration.y = -0.1f;
+	de_color_gradient_t* gradient = de_particle_system_get_color_gradient_over_lifetime(particle_system);
+	de_color_gradient_add_point(gradient, 0.00f, &(de_color_t) { 150, 150, 150, 0 });
+	de_color_gradient_add_point(gradient, 0.05f, &(de_color_t) { 150, 150, 150, 220 });
+	de_color_gradient_add_point(gradient, 0.85f, &(de_color_t) { 255, 255, 255, 180 });
+	de_color_gradient_add_point(gradient, 1.00f, &(de_color_t) { 255, 255, 255, 0 });
+	de_path_t res_path;
+	de_path_from_cstr_as_view(&res_path, LEVEL_LOADER_SMOKE_PATH);
+	de_resource_t* res = de_core_request_resource(loader->game->core, DE_RESOURCE_TYPE_TEXTURE, &res_path);
+	if (res) {
+		de_particle_system_set_texture(particle_system, de_resource_to_texture(res));
+	}
+}
+#endif
+
+static void level_loader_populate(level_loader_t* loader)
+{
+	level_t* level = loader->level;
+
+	if (level->bot_spawns.size) {
+		for (size_t i = 0; i < level->bot_spawns.size; ++i) {
+			actor_t* bot = actor_create(level, ACTOR_TYPE_BOT);
+			actor_set_position(bot, &level->bot_spawns.data[i]);
+		}
+	} else {
+		actor_t* bot = actor_create(level, ACTOR_TYPE_BOT);
+		actor_set_position(bot, &(de_vec3_t){-1.0, 0.0, -1.0});
+	}
+
+	if (level->item_spawns.size) {
+		for (size_t i = 0; i < level->item_spawns.size; ++i) {
+			const level_item_spawn_t* spawn = level->item_spawns.data + i;
+			item_t* item = item_create(level, spawn->type);
+			item_set_position(item, &spawn->position);
+		}
+	} else {
+		item_t* medkit = item_create(level, ITEM_TYPE_MEDKIT);
+		item_set_position(medkit, &(de_vec3_t){0.0f, 0.1f, 0.0f});
+	}
+
+	level->player = actor_create(level, ACTOR_TYPE_PLAYER);
+	if (level->has_player_start) {
+		actor_set_position(level->player, &level->player_start);
+	}
+}
+
+/**
+ * @brief Does one step of current stage and advances to next stage when it is done.
+ */
+static void level_loader_step(level_loader_t* loader)
+{
+	level_t* level = loader->level;
+	switch (loader->stage) {
+		case LEVEL_LOAD_STAGE_ASSETS:
+			asset_registry_request(&level->assets, loader->game->core, loader->asset_index);
+			if (++loader->asset_index < ASSET_COUNT) {
+				return;
+			}
+			break;
+#ifndef SHOOTER_DEDICATED_SERVER
+		/* sounds and purely visual nodes only cost memory and startup time on dedicated server */
+		case LEVEL_LOAD_STAGE_FOOTSTEPS:
+			footstep_sound_map_read(loader->game->core, &level->footstep_sound_map);
+			break;
+		case LEVEL_LOAD_STAGE_DECORATIONS:
+			level_loader_create_decorations(loader);
+			break;
+		case LEVEL_LOAD_STAGE_EFFECTS:
+			level_loader_create_effects(loader);
+			break;
+#else
+		case LEVEL_LOAD_STAGE_FOOTSTEPS:
+		case LEVEL_LOAD_STAGE_DECORATIONS:
+		case LEVEL_LOAD_STAGE_EFFECTS:
+			break;
+#endif
+		case LEVEL_LOAD_STAGE_MAP:
+			/* core parses whole file in one call, so this step is the longest frame of loading */
+			loader->map = level_loader_request_model(loader, level->map_path);
+			if (!loader->map) {
+				de_log("level loader: unable to load map %s", level->map_path);
+			}
+			break;
+		case LEVEL_LOAD_STAGE_MAP_INSTANCE:
+			if (loader->map) {
+				de_model_instantiate(loader->map, level->scene);
+			}
+			break;
+		case LEVEL_LOAD_STAGE_COLLIDER:
+			loader->from_cache = level_cache_load(level);
+			if (!loader->from_cache) {
+				level_create_collider(level);
+			}
+			break;
+		case LEVEL_LOAD_STAGE_ENTITIES:
+			if (!loader->from_cache) {
+				level_scan_scene(level);
+				level_cache_save(level);
+			}
+			break;
+		case LEVEL_LOAD_STAGE_POPULATE:
+			if (loader->populate) {
+				level_loader_populate(loader);
+			}
+			break;
+		case LEVEL_LOAD_STAGE_DONE:
+			return;
+	}
+	++loader->stage;
+	if (loader->stage == LEVEL_LOAD_STAGE_DONE) {
+		de_log("level loader: %s loaded in %.3f s%s", level->map_path, de_time_get_seconds() - loader->start_time,
+			loader->from_cache ? " (from cache)" : "");
+	}
+}
+
+level_loader_t* level_loader_create(game_t* game, const char* map_path, bool populate)
+{
+	level_loader_t* loader = DE_NEW(level_loader_t);
+	loader->game = game;
+	loader->populate = populate;
+	loader->start_time = de_time_get_seconds();
+
+	level_t* level = DE_NEW(level_t);
+	level->game = game;
+	level->scene = de_scene_create(game->core);
+	snprintf(level->map_path, sizeof(level->map_path), "%s", map_path);
+	hitscan_init(&level->hitscan);
+	timer_wheel_init(&level->timers);
+	loader->level = level;
+
+	/* in order of loading, so prefetch stays ahead of main thread */
+	for (int id = 0; id < ASSET_COUNT; ++id) {
+		level_loader_add_prefetch(loader, asset_registry_get_path(id));
+	}
+	level_loader_add_prefetch(loader, LEVEL_LOADER_RIPPER_PATH);
+	level_loader_add_prefetch(loader, level->map_path);
+	level_cache_get_path(level, loader->cache_path, sizeof(loader->cache_path));
+	level_loader_add_prefetch(loader, loader->cache_path);
+	level_loader_add_prefetch(loader, LEVEL_LOADER_SMOKE_PATH);
+
+	de_mtx_init(&loader->lock);
+	de_thread_create(&loader->prefetch_thread, level_prefetch_thread, loader);
+
+	return loader;
+}
+
+bool level_loader_update(level_loader_t* loader, double budget)
+{
+	const double start = de_time_get_seconds();
+	do {
+		level_loader_step(loader);
+	} while (loader->stage != LEVEL_LOAD_STAGE_DONE && de_time_get_seconds() - start < budget);
+	return loader->stage == LEVEL_LOAD_STAGE_DONE;
+}
+
+float level_loader_get_progress(const level_loader_t* loader)
+{
+	int total = 0;
+	int done = 0;
+	for (int stage = 0; stage < LEVEL_LOAD_STAGE_DONE; ++stage) {
+		const int weight = level_load_stage_weights[stage] * (stage == LEVEL_LOAD_STAGE_ASSETS ? ASSET_COUNT : 1);
+		total += weight;
+		if (stage < (int)loader->stage) {
+			done += weight;
+		}
+	}
+	if (loader->stage == LEVEL_LOAD_STAGE_ASSETS) {
+		done += loader->asset_index * level_load_stage_weights[LEVEL_LOAD_STAGE_ASSETS];
+	}
+	return (float)done / (float)total;
+}
+
+static void level_loader_stop_prefetch(level_loader_t* loader)
+{
+	de_mtx_lock(&loader->lock);
+	loader->cancelled = true;
+	de_mtx_unlock(&loader->lock);
+	de_thread_join(&loader->prefetch_thread);
+	de_mtx_destroy(&loader->lock);
+}
+
+level_t* level_loader_finish(level_loader_t* loader)
+{
+	DE_ASSERT(loader->stage == LEVEL_LOAD_STAGE_DONE);
+	level_loader_stop_prefetch(loader);
+	de_log("level loader: %d of %d files prefetched (%d KB)", (int)loader->prefetched_count,
+		(int)loader->prefetch_count, (int)(loader->prefetched_bytes / 1024));
+	level_t* level = loader->level;
+	de_free(loader);
+	return level;
+}
+
+void level_loader_free(level_loader_t* loader)
+{
+	level_loader_stop_prefetch(loader);
+	level_free(loader->level);
+	de_free(loader);
+}
\ No newline at end of file
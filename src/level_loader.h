@@ -0,0 +1,89 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+#define LEVEL_LOADER_MAX_PREFETCH_FILES 32
+
+typedef enum level_load_stage_t {
+	LEVEL_LOAD_STAGE_ASSETS, /**< One asset of registry per step. */
+	LEVEL_LOAD_STAGE_FOOTSTEPS,
+	LEVEL_LOAD_STAGE_DECORATIONS,
+	LEVEL_LOAD_STAGE_MAP, /**< Single blocking parse of map file by core, can't be split. */
+	LEVEL_LOAD_STAGE_MAP_INSTANCE,
+	LEVEL_LOAD_STAGE_COLLIDER,
+	LEVEL_LOAD_STAGE_ENTITIES,
+	LEVEL_LOAD_STAGE_EFFECTS,
+	LEVEL_LOAD_STAGE_POPULATE, /**< Skipped if loader was created without populate flag. */
+	LEVEL_LOAD_STAGE_DONE,
+} level_load_stage_t;
+
+/**
+ * @brief Builds level in small steps so main loop can keep rendering (and menu can
+ * show progress) while level is loading. Resources are parsed and uploaded by
+ * core on main thread, so background thread reads every file level will need
+ * ahead of main thread - when main thread gets to a file, it is already in OS
+ * file cache and parsing does not wait for disk.
+ */
+struct level_loader_t {
+	game_t* game;
+	level_t* level;
+	level_load_stage_t stage;
+	int asset_index; /**< Next asset of registry to request. */
+	bool populate; /**< Spawn bots, items and player like level_create_test does. */
+	bool from_cache; /**< Collider, nav grid and entities were restored from level cache. */
+	de_model_t* map; /**< Parsed by map stage, instantiated by next one. */
+	char cache_path[LEVEL_CACHE_PATH_MAX];
+	double start_time;
+	de_thread_t prefetch_thread;
+	de_mtx_t lock;
+	const char* prefetch_paths[LEVEL_LOADER_MAX_PREFETCH_FILES];
+	size_t prefetch_count;
+	size_t prefetched_count; /**< Protected by lock. */
+	size_t prefetched_bytes; /**< Protected by lock. */
+	bool cancelled; /**< Protected by lock. */
+};
+
+/**
+ * @brief Creates empty level and starts prefetch thread. Nothing is loaded until
+ * level_loader_update is called.
+ */
+level_loader_t* level_loader_create(game_t* game, const char* map_path, bool populate);
+
+/**
+ * @brief Runs loading steps until time budget (in seconds) is spent, at least one
+ * step is done per call. Returns true when level is completely loaded.
+ */
+bool level_loader_update(level_loader_t* loader, double budget);
+
+/**
+ * @brief Returns loading progress in [0; 1] range.
+ */
+float level_loader_get_progress(const level_loader_t* loader);
+
+/**
+ * @brief Stops prefetch thread, frees loader and returns loaded level.
+ */
+level_t* level_loader_finish(level_loader_t* loader);
+
+/**
+ * @brief Stops loading and frees partially loaded level.
+ */
+void level_loader_free(level_loader_t* loader);
\ No newline at end of file
@@ -65,11 +65,13 @@ static void menu_on_new_game_click(de_gui_node_t* node, void* user_data)
 
 	DE_UNUSED(node);
 
-	if (!game->level) {
-		game->level = level_create_test(game);
+	if (game->level) {
+		menu_set_visible(game->main_menu, false);
+	} else if (!game->loader) {
+		/* menu is hidden by main loop when loading is done */
+		game->loader = level_loader_create(game, LEVEL_TEST_MAP_PATH, true);
+		menu_set_loading_progress(game->main_menu, 0.0f);
 	}
-
-	menu_set_visible(game->main_menu, false);
 }
 
 static void menu_set_page(menu_t* menu, menu_page_type_t page)
@@ -91,7 +93,10 @@ static void menu_on_load_click(de_gui_node_t* node, void* user_data)
 {
 	DE_UNUSED(node);
 	game_t* game = (game_t*)user_data;	
-	game_load(game);
+	/* loaded level would be replaced by one that is loading */
+	if (!game->loader) {
+		game_load(game);
+	}
 }
 
 static void menu_on_settings_click(de_gui_node_t* node, void* user_data)
@@ -677,9 +682,29 @@ static void main_page_init(menu_t* menu, main_page_t* page)
 		}
 	});
 
+	/* loading progress */
+	page->loading_text = de_gui_node_create_with_desc(gui, DE_GUI_NODE_TEXT, &(de_gui_node_descriptor_t) {
+		.row = 5,
+		.parent = grid,
+		.margin = de_gui_thickness_uniform(10),
+		.s.text_block = (de_gui_text_descriptor_t) {
+			.horizontal_alignment = DE_GUI_HORIZONTAL_ALIGNMENT_CENTER,
+			.vertical_alignment = DE_GUI_VERTICAL_ALIGNMENT_CENTER,
+		}
+	});
+
 	de_gui_window_set_content(page->window, grid);
 }
 
+void menu_set_loading_progress(menu_t* menu, float progress)
+{
+	char buffer[64] = { 0 };
+	if (progress >= 0.0f) {
+		snprintf(buffer, sizeof(buffer), "Loading... %d%%", (int)(progress * 100.0f));
+	}
+	de_gui_text_set_text_utf8(menu->main_page.loading_text, buffer);
+}
+
 menu_t* menu_create(game_t* game)
 {
 	de_gui_t* gui = de_core_get_gui(game->core);
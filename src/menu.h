@@ -26,6 +26,7 @@ typedef enum menu_page_type_t {
 
 typedef struct main_page_t {
 	de_gui_node_t* window;
+	de_gui_node_t* loading_text;
 } main_page_t;
 
 typedef struct settings_page_t {
@@ -59,6 +60,11 @@ struct menu_t {
 
 menu_t* menu_create(game_t* game);
 
+/**
+ * @brief Shows progress of level loading on main page, negative progress hides it.
+ */
+void menu_set_loading_progress(menu_t* menu, float progress);
+
 void menu_set_visible(menu_t* menu, bool visibility);
 
 void menu_free(menu_t* menu);
@@ -0,0 +1,398 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+#define NAV_WALKABLE_SLOPE 0.7f
+#define NAV_STEP_HEIGHT 0.3f
+#define NAV_AGENT_HEIGHT 1.0f
+/* relative area below which triangle projected onto XZ is treated as segment */
+#define NAV_DEGENERATE_TOLERANCE 1e-5f
+#define NAV_LAYER_MERGE_DISTANCE 0.1f
+/* bots are pivoted at capsule center, so feet are a bit below */
+#define NAV_QUERY_HEIGHT_TOLERANCE 1.0f
+
+/* 8 directions, first four are orthogonal, opposite directions differ only in lowest bit */
+static const int nav_dx[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+static const int nav_dz[8] = { 0, 0, 1, -1, 1, -1, -1, 1 };
+
+static float nav_min3(float a, float b, float c)
+{
+	return a < b ? (a < c ? a : c) : (b < c ? b : c);
+}
+
+static float nav_max3(float a, float b, float c)
+{
+	return a > b ? (a > c ? a : c) : (b > c ? b : c);
+}
+
+static int nav_clamp(int v, int min, int max)
+{
+	return v < min ? min : (v > max ? max : v);
+}
+
+static nav_cell_t* nav_grid_get_cell(const nav_grid_t* grid, int x, int z)
+{
+	return grid->cells + z * grid->width + x;
+}
+
+/**
+ * @brief Calculates height of triangle plane at (x, z) if point is inside triangle
+ * projected onto XZ plane.
+ */
+static bool nav_triangle_height_at(const de_static_triangle_t* triangle, float x, float z, float* height)
+{
+	const de_vec3_t* a = &triangle->a;
+	const de_vec3_t* b = &triangle->b;
+	const de_vec3_t* c = &triangle->c;
+	const float det = (b->z - c->z) * (a->x - c->x) + (c->x - b->x) * (a->z - c->z);
+	if (fabsf(det) < FLT_EPSILON) {
+		return false;
+	}
+	const float u = ((b->z - c->z) * (x - c->x) + (c->x - b->x) * (z - c->z)) / det;
+	const float v = ((c->z - a->z) * (x - c->x) + (a->x - c->x) * (z - c->z)) / det;
+	const float w = 1.0f - u - v;
+	if (u < 0.0f || v < 0.0f || w < 0.0f) {
+		return false;
+	}
+	*height = u * a->y + v * b->y + w * c->y;
+	return true;
+}
+
+static void nav_cell_add_floor(nav_cell_t* cell, float height)
+{
+	for (int i = 0; i < cell->layer_count; ++i) {
+		if (fabsf(cell->floor[i] - height) < NAV_LAYER_MERGE_DISTANCE) {
+			if (height > cell->floor[i]) {
+				cell->floor[i] = height;
+			}
+			return;
+		}
+	}
+	if (cell->layer_count < NAV_MAX_LAYERS) {
+		cell->floor[cell->layer_count++] = height;
+	}
+}
+
+static void nav_grid_get_cell_range(const nav_grid_t* grid, const de_static_triangle_t* triangle, int* x0, int* z0, int* x1, int* z1)
+{
+	const float inv_cell_size = 1.0f / grid->cell_size;
+	*x0 = nav_clamp((int)((nav_min3(triangle->a.x, triangle->b.x, triangle->c.x) - grid->origin.x) * inv_cell_size), 0, grid->width - 1);
+	*z0 = nav_clamp((int)((nav_min3(triangle->a.z, triangle->b.z, triangle->c.z) - grid->origin.z) * inv_cell_size), 0, grid->depth - 1);
+	*x1 = nav_clamp((int)((nav_max3(triangle->a.x, triangle->b.x, triangle->c.x) - grid->origin.x) * inv_cell_size), 0, grid->width - 1);
+	*z1 = nav_clamp((int)((nav_max3(triangle->a.z, triangle->b.z, triangle->c.z) - grid->origin.z) * inv_cell_size), 0, grid->depth - 1);
+}
+
+static void nav_grid_rasterize_floor(nav_grid_t* grid, const de_static_triangle_t* triangle)
+{
+	int x0, z0, x1, z1;
+	nav_grid_get_cell_range(grid, triangle, &x0, &z0, &x1, &z1);
+	for (int z = z0; z <= z1; ++z) {
+		for (int x = x0; x <= x1; ++x) {
+			const float cx = grid->origin.x + ((float)x + 0.5f) * grid->cell_size;
+			const float cz = grid->origin.z + ((float)z + 0.5f) * grid->cell_size;
+			float height;
+			if (nav_triangle_height_at(triangle, cx, cz, &height)) {
+				nav_cell_add_floor(nav_grid_get_cell(grid, x, z), height);
+			}
+		}
+	}
+}
+
+bool nav_triangle_overlaps_square(const de_static_triangle_t* triangle, float min_x, float min_z, float max_x, float max_z)
+{
+	const float px[3] = { triangle->a.x, triangle->b.x, triangle->c.x };
+	const float pz[3] = { triangle->a.z, triangle->b.z, triangle->c.z };
+
+	/* vertical wall projects onto XZ as a segment: third vertex lies on line of every
+	 * edge, so edge normals can't separate anything and segment is tested on its own */
+	const float double_area = (px[1] - px[0]) * (pz[2] - pz[0]) - (pz[1] - pz[0]) * (px[2] - px[0]);
+	int longest = 0;
+	float longest_sqr_len = 0.0f;
+	for (int i = 0; i < 3; ++i) {
+		const int j = (i + 1) % 3;
+		const float sqr_len = (px[j] - px[i]) * (px[j] - px[i]) + (pz[j] - pz[i]) * (pz[j] - pz[i]);
+		if (sqr_len > longest_sqr_len) {
+			longest_sqr_len = sqr_len;
+			longest = i;
+		}
+	}
+	if (fabsf(double_area) <= NAV_DEGENERATE_TOLERANCE * longest_sqr_len) {
+		if (longest_sqr_len < FLT_EPSILON) {
+			/* projects to point, bounds of caller already contain it */
+			return true;
+		}
+		/* longest edge spans all three vertices, square must have corners on both sides of it */
+		const int i = longest;
+		const int j = (i + 1) % 3;
+		const float nx = pz[j] - pz[i];
+		const float nz = px[i] - px[j];
+		const float edge_proj = nx * px[i] + nz * pz[i];
+		const float square_min_proj = nx * (nx > 0.0f ? min_x : max_x) + nz * (nz > 0.0f ? min_z : max_z);
+		const float square_max_proj = nx * (nx > 0.0f ? max_x : min_x) + nz * (nz > 0.0f ? max_z : min_z);
+		return square_min_proj <= edge_proj && square_max_proj >= edge_proj;
+	}
+
+	for (int i = 0; i < 3; ++i) {
+		const int j = (i + 1) % 3;
+		/* normal of edge */
+		const float nx = pz[j] - pz[i];
+		const float nz = px[i] - px[j];
+		const float tri_proj = nx * px[(i + 2) % 3] + nz * pz[(i + 2) % 3];
+		const float edge_proj = nx * px[i] + nz * pz[i];
+		/* corner of square that goes farthest towards the triangle side of edge, if even
+		 * it is on the other side, edge separates them */
+		const float sx = (tri_proj > edge_proj) == (nx > 0.0f) ? max_x : min_x;
+		const float sz = (tri_proj > edge_proj) == (nz > 0.0f) ? max_z : min_z;
+		const float square_proj = nx * sx + nz * sz;
+		if ((tri_proj > edge_proj && square_proj < edge_proj) || (tri_proj < edge_proj && square_proj > edge_proj)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void nav_grid_rasterize_obstacle(nav_grid_t* grid, const de_static_triangle_t* triangle)
+{
+	const float min_y = nav_min3(triangle->a.y, triangle->b.y, triangle->c.y);
+	const float max_y = nav_max3(triangle->a.y, triangle->b.y, triangle->c.y);
+	int x0, z0, x1, z1;
+	nav_grid_get_cell_range(grid, triangle, &x0, &z0, &x1, &z1);
+	for (int z = z0; z <= z1; ++z) {
+		for (int x = x0; x <= x1; ++x) {
+			nav_cell_t* cell = nav_grid_get_cell(grid, x, z);
+			if (!cell->layer_count) {
+				continue;
+			}
+			const float cell_min_x = grid->origin.x + (float)x * grid->cell_size;
+			const float cell_min_z = grid->origin.z + (float)z * grid->cell_size;
+			if (!nav_triangle_overlaps_square(triangle, cell_min_x, cell_min_z, cell_min_x + grid->cell_size, cell_min_z + grid->cell_size)) {
+				continue;
+			}
+			for (int i = 0; i < cell->layer_count; ++i) {
+				/* obstacle blocks floor if it occupies space where agent stands */
+				if (max_y > cell->floor[i] + NAV_STEP_HEIGHT && min_y < cell->floor[i] + NAV_AGENT_HEIGHT) {
+					cell->blocked_mask |= (uint8_t)(1 << i);
+				}
+			}
+		}
+	}
+}
+
+nav_grid_t* nav_grid_create_with_size(const de_vec3_t* origin, float cell_size, int width, int depth)
+{
+	nav_grid_t* grid = DE_NEW(nav_grid_t);
+	grid->origin = *origin;
+	grid->cell_size = cell_size;
+	grid->target_node = NAV_INVALID_NODE;
+	grid->width = width;
+	grid->depth = depth;
+
+	const size_t cell_count = (size_t)grid->width * (size_t)grid->depth;
+	const size_t node_count = cell_count * NAV_MAX_LAYERS;
+	if (cell_count) {
+		grid->cells = de_calloc(cell_count, sizeof(*grid->cells));
+		grid->distance = de_calloc(node_count, sizeof(*grid->distance));
+		grid->flow = de_calloc(node_count, sizeof(*grid->flow));
+		grid->queue = de_calloc(node_count, sizeof(*grid->queue));
+	}
+	return grid;
+}
+
+nav_grid_t* nav_grid_create(const de_static_geometry_t* collider, float cell_size)
+{
+	const double start_time = de_time_get_seconds();
+	if (!collider->triangles.size) {
+		return nav_grid_create_with_size(&(de_vec3_t) { 0 }, cell_size, 0, 0);
+	}
+
+	/* bounds */
+	de_vec3_t min = collider->triangles.data[0].a;
+	de_vec3_t max = min;
+	for (size_t i = 0; i < collider->triangles.size; ++i) {
+		const de_static_triangle_t* triangle = collider->triangles.data + i;
+		const de_vec3_t* points[3] = { &triangle->a, &triangle->b, &triangle->c };
+		for (int k = 0; k < 3; ++k) {
+			min.x = points[k]->x < min.x ? points[k]->x : min.x;
+			min.z = points[k]->z < min.z ? points[k]->z : min.z;
+			max.x = points[k]->x > max.x ? points[k]->x : max.x;
+			max.z = points[k]->z > max.z ? points[k]->z : max.z;
+		}
+	}
+	const int width = (int)ceilf((max.x - min.x) / cell_size) + 1;
+	const int depth = (int)ceilf((max.z - min.z) / cell_size) + 1;
+	nav_grid_t* grid = nav_grid_create_with_size(&min, cell_size, width, depth);
+
+	/* floors first, obstacles are tested against them */
+	for (size_t i = 0; i < collider->triangles.size; ++i) {
+		const de_static_triangle_t* triangle = collider->triangles.data + i;
+		if (triangle->normal.y > NAV_WALKABLE_SLOPE) {
+			nav_grid_rasterize_floor(grid, triangle);
+		}
+	}
+	for (size_t i = 0; i < collider->triangles.size; ++i) {
+		const de_static_triangle_t* triangle = collider->triangles.data + i;
+		if (triangle->normal.y <= NAV_WALKABLE_SLOPE) {
+			nav_grid_rasterize_obstacle(grid, triangle);
+		}
+	}
+
+	grid->bake_time = de_time_get_seconds() - start_time;
+	de_log("nav: %dx%d grid baked from %d triangles in %.3f ms", grid->width, grid->depth,
+		(int)collider->triangles.size, grid->bake_time * 1000.0);
+
+	return grid;
+}
+
+void nav_grid_free(nav_grid_t* grid)
+{
+	if (grid->cells) {
+		de_free(grid->cells);
+		de_free(grid->distance);
+		de_free(grid->flow);
+		de_free(grid->queue);
+	}
+	de_free(grid);
+}
+
+static bool nav_grid_is_walkable(const nav_grid_t* grid, int x, int z, int layer)
+{
+	const nav_cell_t* cell = nav_grid_get_cell(grid, x, z);
+	return layer < cell->layer_count && !(cell->blocked_mask & (1 << layer));
+}
+
+/**
+ * @brief Finds layer of neighbour cell reachable from given floor height, or -1.
+ */
+static int nav_grid_find_connected_layer(const nav_grid_t* grid, int x, int z, float height)
+{
+	if (x < 0 || z < 0 || x >= grid->width || z >= grid->depth) {
+		return -1;
+	}
+	const nav_cell_t* cell = nav_grid_get_cell(grid, x, z);
+	for (int i = 0; i < cell->layer_count; ++i) {
+		if (!(cell->blocked_mask & (1 << i)) && fabsf(cell->floor[i] - height) <= NAV_STEP_HEIGHT) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int nav_grid_find_node(const nav_grid_t* grid, const de_vec3_t* position)
+{
+	if (!grid->cells) {
+		return NAV_INVALID_NODE;
+	}
+	const int x = (int)floorf((position->x - grid->origin.x) / grid->cell_size);
+	const int z = (int)floorf((position->z - grid->origin.z) / grid->cell_size);
+	if (x < 0 || z < 0 || x >= grid->width || z >= grid->depth) {
+		return NAV_INVALID_NODE;
+	}
+	/* highest walkable floor below point */
+	const nav_cell_t* cell = nav_grid_get_cell(grid, x, z);
+	int best_layer = -1;
+	for (int i = 0; i < cell->layer_count; ++i) {
+		const float floor = cell->floor[i];
+		if (nav_grid_is_walkable(grid, x, z, i) && floor <= position->y + NAV_STEP_HEIGHT && floor >= position->y - NAV_QUERY_HEIGHT_TOLERANCE) {
+			if (best_layer < 0 || floor > cell->floor[best_layer]) {
+				best_layer = i;
+			}
+		}
+	}
+	if (best_layer < 0) {
+		return NAV_INVALID_NODE;
+	}
+	return (z * grid->width + x) * NAV_MAX_LAYERS + best_layer;
+}
+
+/**
+ * @brief Breadth-first search from target over 8-connected nodes, then each node
+ * gets direction to neighbour that is closer to target.
+ */
+static void nav_grid_build_flow(nav_grid_t* grid)
+{
+	const size_t node_count = (size_t)grid->width * (size_t)grid->depth * NAV_MAX_LAYERS;
+	memset(grid->distance, 0xFF, node_count * sizeof(*grid->distance));
+	memset(grid->flow, NAV_NO_DIRECTION, node_count * sizeof(*grid->flow));
+	if (grid->target_node == NAV_INVALID_NODE) {
+		return;
+	}
+
+	size_t head = 0;
+	size_t tail = 0;
+	grid->distance[grid->target_node] = 0;
+	grid->queue[tail++] = grid->target_node;
+	while (head < tail) {
+		const int node = grid->queue[head++];
+		const int cell_index = node / NAV_MAX_LAYERS;
+		const int x = cell_index % grid->width;
+		const int z = cell_index / grid->width;
+		const float height = grid->cells[cell_index].floor[node % NAV_MAX_LAYERS];
+		for (int dir = 0; dir < 8; ++dir) {
+			const int nx = x + nav_dx[dir];
+			const int nz = z + nav_dz[dir];
+			const int layer = nav_grid_find_connected_layer(grid, nx, nz, height);
+			if (layer < 0) {
+				continue;
+			}
+			/* do not cut corners */
+			if (dir >= 4 && (nav_grid_find_connected_layer(grid, nx, z, height) < 0 || nav_grid_find_connected_layer(grid, x, nz, height) < 0)) {
+				continue;
+			}
+			const int neighbour = (nz * grid->width + nx) * NAV_MAX_LAYERS + layer;
+			if (grid->distance[neighbour] == UINT32_MAX) {
+				grid->distance[neighbour] = grid->distance[node] + 1;
+				/* neighbour reached from node, so to go to target it must move back */
+				grid->flow[neighbour] = (uint8_t)(dir ^ 1);
+				grid->queue[tail++] = neighbour;
+			}
+		}
+	}
+}
+
+void nav_grid_set_target(nav_grid_t* grid, const de_vec3_t* target)
+{
+	const int node = nav_grid_find_node(grid, target);
+	if (node == grid->target_node || node == NAV_INVALID_NODE) {
+		return;
+	}
+	const double start_time = de_time_get_seconds();
+	grid->target_node = node;
+	nav_grid_build_flow(grid);
+	grid->flow_time = de_time_get_seconds() - start_time;
+	++grid->flow_rebuild_count;
+}
+
+bool nav_grid_get_flow(const nav_grid_t* grid, const de_vec3_t* position, de_vec3_t* direction)
+{
+	const int node = nav_grid_find_node(grid, position);
+	if (node == NAV_INVALID_NODE) {
+		return false;
+	}
+	const uint8_t dir = grid->flow[node];
+	if (dir == NAV_NO_DIRECTION) {
+		return false;
+	}
+	direction->x = (float)nav_dx[dir];
+	direction->y = 0.0f;
+	direction->z = (float)nav_dz[dir];
+	de_vec3_normalize(direction, direction);
+	return true;
+}
\ No newline at end of file
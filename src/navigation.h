@@ -0,0 +1,92 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+#define NAV_MAX_LAYERS 4
+#define NAV_NO_DIRECTION 0xFF
+#define NAV_INVALID_NODE (-1)
+
+/**
+ * @brief Column of navigation grid. Each column can have several walkable floors
+ * (layers) stacked on top of each other, so multi-storey maps are supported.
+ */
+typedef struct nav_cell_t {
+	float floor[NAV_MAX_LAYERS];
+	uint8_t layer_count;
+	uint8_t blocked_mask; /**< Bit per layer, set when something is in the way above floor. */
+} nav_cell_t;
+
+/**
+ * @brief 2.5D voxel grid built from level collider plus flow field towards single
+ * target. Node is cell index * NAV_MAX_LAYERS + layer. Flow field is shared by
+ * every bot, so each bot only needs O(1) lookup per tick.
+ */
+typedef struct nav_grid_t {
+	de_vec3_t origin; /**< Minimal corner of grid. */
+	float cell_size;
+	int width; /**< Amount of cells along X axis. */
+	int depth; /**< Amount of cells along Z axis. */
+	nav_cell_t* cells;
+	uint32_t* distance; /**< Per-node distance to target in steps. */
+	uint8_t* flow; /**< Per-node index of direction towards target. */
+	int* queue;
+	int target_node;
+	double bake_time; /**< Seconds spent to build grid. */
+	double flow_time; /**< Seconds spent to build last flow field. */
+	size_t flow_rebuild_count;
+} nav_grid_t;
+
+/**
+ * @brief Builds grid from walkable (floor) and blocking (wall) triangles of level collider.
+ */
+nav_grid_t* nav_grid_create(const de_static_geometry_t* collider, float cell_size);
+
+/**
+ * @brief Creates grid with empty cells, used to restore baked grid from level cache.
+ */
+nav_grid_t* nav_grid_create_with_size(const de_vec3_t* origin, float cell_size, int width, int depth);
+
+void nav_grid_free(nav_grid_t* grid);
+
+/**
+ * @brief Separating axis test of triangle and axis-aligned square on XZ plane. Only
+ * edge normals (or normal of segment, if triangle is vertical) are tested, caller
+ * must limit squares to bounds of triangle.
+ */
+bool nav_triangle_overlaps_square(const de_static_triangle_t* triangle, float min_x, float min_z, float max_x, float max_z);
+
+/**
+ * @brief Returns node under given point or NAV_INVALID_NODE.
+ */
+int nav_grid_find_node(const nav_grid_t* grid, const de_vec3_t* position);
+
+/**
+ * @brief Rebuilds flow field if target moved into other node. Must be called from
+ * main thread before bots are querying flow.
+ */
+void nav_grid_set_target(nav_grid_t* grid, const de_vec3_t* target);
+
+/**
+ * @brief Writes normalized XZ direction towards current target. Returns false if
+ * point is off grid or target is not reachable from it. Read-only, can be called
+ * from any thread.
+ */
+bool nav_grid_get_flow(const nav_grid_t* grid, const de_vec3_t* position, de_vec3_t* direction);
\ No newline at end of file
@@ -21,11 +21,7 @@
 
 static bool player_process_event(actor_t* actor, const de_event_t* evt)
 {
-	player_t* p = &actor->s.player;
-	de_vec3_t position;
-	de_node_get_global_position(p->camera, &position);
-	de_vec3_t look;
-	de_node_get_look_vector(p->camera, &look);
+	player_t* p = actor_to_player(actor);
 	bool processed = false;
 	switch (evt->type) {
 		case DE_EVENT_TYPE_MOUSE_MOVE:
@@ -56,14 +52,11 @@ static bool player_process_event(actor_t* actor, const de_event_t* evt)
 					p->controller.crouch = true;
 					break;
 				case DE_KEY_G:
-					/* throw grenade */
-					projectile_create(actor->parent_level, PROJECTILE_TYPE_GRENADE, &position, &look);
+					p->controller.throw_grenade = true;
 					break;
 				case DE_KEY_Space:
 					if (!p->controller.jumped) {
-						if (actor_has_ground_contact(actor)) {
-							de_body_set_y_velocity(actor->body, 0.085f);
-						}
+						p->controller.jump = true;
 						p->controller.jumped = true;
 					}
 					break;
@@ -110,9 +103,9 @@ static bool player_process_event(actor_t* actor, const de_event_t* evt)
 		case DE_EVENT_TYPE_MOUSE_WHEEL: {
 			int delta = evt->s.mouse_wheel.delta;
 			if (delta > 0) {
-				player_next_weapon(p);
+				++p->controller.weapon_switch;
 			} else if (delta < 0) {
-				player_prev_weapon(p);
+				--p->controller.weapon_switch;
 			}
 			break;
 		}
@@ -132,7 +125,9 @@ static weapon_t* player_get_current_weapon(player_t* player)
 
 static void player_init(actor_t* actor)
 {
-	player_t* p = &actor->s.player;
+	player_t* p = DE_NEW(player_t);
+	p->actor = actor;
+	actor->s.player = p;
 	actor->move_speed = 0.06f;
 	p->stand_body_height = 0.5f;
 	p->crouch_body_height = 0.30f;
@@ -168,57 +163,135 @@ static void player_init(actor_t* actor)
 	player_add_weapon(p, weapon_create(level, WEAPON_TYPE_M4));
 	player_add_weapon(p, weapon_create(level, WEAPON_TYPE_AK47));
 
-	de_path_t path;
-	de_path_from_cstr_as_view(&path, "data/models/sphere.fbx");
-	de_resource_t* res = de_core_request_resource(actor->parent_level->game->core, DE_RESOURCE_TYPE_MODEL, &path);
-	p->ray_cast_pick = de_model_instantiate(de_resource_to_model(res), actor->parent_level->scene);
-}
-
-static bool player_visit(de_object_visitor_t* visitor, actor_t* actor)
-{
-	player_t* player = &actor->s.player;
-	bool result = true;
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "Camera", &player->camera, de_node_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "FlashLight", &player->flash_light, de_node_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "WeaponPivot", &player->weapon_pivot, de_node_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "LaserDot", &player->laser_dot, de_node_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "PickSphere", &player->ray_cast_pick, de_node_visit);
-	result &= de_object_visitor_visit_float(visitor, "Pitch", &player->pitch);
-	result &= de_object_visitor_visit_float(visitor, "DesiredPitch", &player->desired_pitch);
-	result &= de_object_visitor_visit_float(visitor, "Yaw", &player->yaw);
-	result &= de_object_visitor_visit_float(visitor, "DesiredYaw", &player->desired_yaw);
-	result &= de_object_visitor_visit_float(visitor, "StandBodyRadius", &player->stand_body_height);
-	result &= de_object_visitor_visit_float(visitor, "CrouchBodyRadius", &player->crouch_body_height);
-	result &= de_object_visitor_visit_float(visitor, "StandUpSpeed", &player->stand_up_speed);
-	result &= de_object_visitor_visit_float(visitor, "SitDownSpeed", &player->sit_down_speed);
-	result &= de_object_visitor_visit_float(visitor, "RunSpeedMultiplier", &player->run_speed_multiplier);
-	result &= de_object_visitor_visit_float(visitor, "CameraWobble", &player->camera_wobble);
-	result &= de_object_visitor_visit_float(visitor, "PathLength", &player->path_len);
-	result &= de_object_visitor_visit_vec3(visitor, "CameraOffset", &player->camera_offset);
-	result &= de_object_visitor_visit_vec3(visitor, "CameraDestOffset", &player->camera_dest_offset);
-	result &= de_object_visitor_visit_vec3(visitor, "CameraPosition", &player->camera_position);
-	result &= de_object_visitor_visit_vec3(visitor, "WeaponOffset", &player->weapon_offset);
-	result &= de_object_visitor_visit_vec3(visitor, "WeaponDestOffset", &player->weapon_dest_offset);
-	result &= de_object_visitor_visit_vec3(visitor, "WeaponPosition", &player->weapon_position);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER_ARRAY(visitor, "Weapons", player->weapons, weapon_visit);	
-	return result;
+	de_model_t* sphere = asset_registry_get_model(&actor->parent_level->assets, ASSET_MODEL_SPHERE);
+	p->ray_cast_pick = de_model_instantiate(sphere, actor->parent_level->scene);
 }
 
 static void player_deinit(actor_t* actor)
 {
-	player_t* p = &actor->s.player;
+	player_t* p = actor_to_player(actor);
 	for (size_t i = 0; i < p->weapons.size; ++i) {
 		weapon_free(p->weapons.data[i]);
 	}
 	DE_ARRAY_FREE(p->weapons);
+	DE_ARRAY_FREE(p->ray_cast_list);
+	de_free(p);
+}
+
+/**
+ * @brief Updates laser sight. World is queried without sorting (bodies are ignored,
+ * so own body does not need to be filtered out) and only if camera has moved beyond
+ * tolerance since last query; actors move on their own, so they are tested every tick, but only
+ * against capsules, which is much cheaper than scene query.
+ */
+static void player_update_aim(player_t* player, const de_vec3_t* origin, const de_vec3_t* look)
+{
+	player_aim_t* aim = &player->aim;
+	actor_t* self = player->actor;
+	level_t* level = self->parent_level;
+
+	/* compared against cached ray, not previous tick, so slow drift can't accumulate */
+	de_vec3_t origin_delta, look_delta;
+	de_vec3_sub(&origin_delta, origin, &aim->ray.origin);
+	de_vec3_sub(&look_delta, look, &aim->look);
+	const bool camera_moved = !aim->valid ||
+		de_vec3_sqr_len(&origin_delta) > PLAYER_AIM_ORIGIN_TOLERANCE * PLAYER_AIM_ORIGIN_TOLERANCE ||
+		de_vec3_sqr_len(&look_delta) > PLAYER_AIM_LOOK_TOLERANCE * PLAYER_AIM_LOOK_TOLERANCE;
+	if (camera_moved) {
+		aim->valid = true;
+		aim->look = *look;
+		aim->ray.origin = *origin;
+		de_vec3_scale(&aim->ray.dir, look, PLAYER_LASER_SIGHT_RANGE);
+		aim->world_hit_distance = FLT_MAX;
+		++aim->world_query_count;
+		if (de_ray_cast(level->scene, &aim->ray, DE_RAY_CAST_FLAGS_IGNORE_BODY, &player->ray_cast_list)) {
+			float closest_sqr_distance = FLT_MAX;
+			for (size_t i = 0; i < player->ray_cast_list.size; ++i) {
+				const de_ray_cast_result_t* result = player->ray_cast_list.data + i;
+				if (result->sqr_distance < closest_sqr_distance) {
+					closest_sqr_distance = result->sqr_distance;
+					aim->world_hit_position = result->position;
+					aim->world_hit_normal = result->normal;
+				}
+			}
+			aim->world_hit_distance = sqrtf(closest_sqr_distance);
+		}
+	}
+
+	aim->hit_distance = aim->world_hit_distance;
+	aim->hit_position = aim->world_hit_position;
+	aim->hit_normal = aim->world_hit_normal;
+	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+		if (actor == self) {
+			continue;
+		}
+		de_vec3_t center;
+		de_node_get_global_position(actor->pivot, &center);
+		de_capsule_shape_t* capsule = de_convex_shape_to_capsule(de_body_get_shape(actor->body));
+		const float half_height = de_capsule_shape_get_height(capsule) * 0.5f;
+		const float t = ray_capsule_intersect(&aim->ray, center.x, center.y, center.z, half_height, de_capsule_shape_get_radius(capsule));
+		const float distance = t * PLAYER_LASER_SIGHT_RANGE;
+		if (t != FLT_MAX && distance < aim->hit_distance) {
+			aim->hit_distance = distance;
+			de_vec3_t offset;
+			de_vec3_scale(&offset, &aim->ray.dir, t);
+			de_vec3_add(&aim->hit_position, &aim->ray.origin, &offset);
+			/* normal points from closest point on capsule axis */
+			de_vec3_t axis_point = center;
+			if (aim->hit_position.y > center.y + half_height) {
+				axis_point.y = center.y + half_height;
+			} else if (aim->hit_position.y < center.y - half_height) {
+				axis_point.y = center.y - half_height;
+			} else {
+				axis_point.y = aim->hit_position.y;
+			}
+			de_vec3_sub(&aim->hit_normal, &aim->hit_position, &axis_point);
+		}
+	}
+}
+
+/**
+ * @brief Performs one-shot actions requested by controller.
+ */
+static void player_process_actions(player_t* player)
+{
+	actor_t* actor = player->actor;
+	player_controller_t* controller = &player->controller;
+
+	if (controller->throw_grenade) {
+		de_vec3_t position;
+		de_node_get_global_position(player->camera, &position);
+		de_vec3_t look;
+		de_node_get_look_vector(player->camera, &look);
+		projectile_create(actor->parent_level, PROJECTILE_TYPE_GRENADE, &position, &look);
+		controller->throw_grenade = false;
+	}
+
+	if (controller->jump) {
+		if (actor_has_ground_contact(actor)) {
+			de_body_set_y_velocity(actor->body, 0.085f * game_get_tick_scale(actor->parent_level->game));
+		}
+		controller->jump = false;
+	}
+
+	for (; controller->weapon_switch > 0; --controller->weapon_switch) {
+		player_next_weapon(player);
+	}
+	for (; controller->weapon_switch < 0; ++controller->weapon_switch) {
+		player_prev_weapon(player);
+	}
 }
 
 static void player_update(actor_t* actor)
 {
-	player_t* player = &actor->s.player;
+	player_t* player = actor_to_player(actor);
 	de_node_t* pivot = actor->pivot;
 	de_node_t* camera = player->camera;
 	de_body_t* body = actor->body;
+	const game_t* game = actor->parent_level->game;
+	const float tick_scale = game_get_tick_scale(game);
+
+	player_process_actions(player);
 
 	de_vec3_t look = (de_vec3_t) { 0 };
 	de_node_get_look_vector(pivot, &look);
@@ -256,20 +329,21 @@ static void player_update(actor_t* actor)
 	/* crouch */
 	if (player->controller.crouch) {
 		float height = actual_height;
-		height -= player->sit_down_speed;
+		height -= player->sit_down_speed * tick_scale;
 		if (height < player->crouch_body_height) {
 			height = player->crouch_body_height;
 		}
 		de_capsule_shape_set_height(capsule_shape, height);
-	} else {
-		/* make sure that we have enough space to stand up by casting ray up */
+	} else if (player->is_crouch) {
+		/* make sure that we have enough space to stand up by casting ray up,
+		 * nothing to check if player is already standing */
 		de_ray_t probe_ray;
 		de_vec3_t probe_ray_end;
 		de_vec3_add(&probe_ray_end, &body->position, &(de_vec3_t) {0, player->stand_body_height, 0});
 		de_ray_by_two_points(&probe_ray, &body->position, &probe_ray_end);
 		if (!de_ray_cast(actor->parent_level->scene, &probe_ray, DE_RAY_CAST_FLAGS_IGNORE_BODY, &player->ray_cast_list)) {
 			float height = actual_height;
-			height += player->stand_up_speed;
+			height += player->stand_up_speed * tick_scale;
 			if (height > player->stand_body_height) {
 				height = player->stand_body_height;
 			}
@@ -281,13 +355,6 @@ static void player_update(actor_t* actor)
 		weapon_update(player->weapons.data[i]);
 	}
 
-	if (player->controller.shoot) {
-		weapon_t* wpn = player_get_current_weapon(player);
-		if (wpn) {
-			weapon_shoot(wpn);
-		}
-	}
-
 	/* make sure that camera will be always at the top of the body */
 	player->camera_position.y = actual_height;
 
@@ -299,7 +366,7 @@ static void player_update(actor_t* actor)
 		player->weapon_dest_offset.x = 0.0125f * (float)cos(player->camera_wobble * 0.5f);
 		player->weapon_dest_offset.y = 0.0125f * (float)sin(player->camera_wobble);
 
-		player->camera_wobble += 0.25f;
+		player->camera_wobble += 0.25f * tick_scale;
 	} else {
 		player->camera_dest_offset.x = 0;
 		player->camera_dest_offset.y = 0;
@@ -309,13 +376,14 @@ static void player_update(actor_t* actor)
 	}
 
 	/* camera offset will follow destination offset -> smooth movements */
-	player->camera_offset.x += (player->camera_dest_offset.x - player->camera_offset.x) * 0.1f;
-	player->camera_offset.y += (player->camera_dest_offset.y - player->camera_offset.y) * 0.1f;
-	player->camera_offset.z += (player->camera_dest_offset.z - player->camera_offset.z) * 0.1f;
+	const float offset_smoothing = game_get_smoothing(game, 0.1f);
+	player->camera_offset.x += (player->camera_dest_offset.x - player->camera_offset.x) * offset_smoothing;
+	player->camera_offset.y += (player->camera_dest_offset.y - player->camera_offset.y) * offset_smoothing;
+	player->camera_offset.z += (player->camera_dest_offset.z - player->camera_offset.z) * offset_smoothing;
 
-	player->weapon_offset.x += (player->weapon_dest_offset.x - player->weapon_offset.x) * 0.1f;
-	player->weapon_offset.y += (player->weapon_dest_offset.y - player->weapon_offset.y) * 0.1f;
-	player->weapon_offset.z += (player->weapon_dest_offset.z - player->weapon_offset.z) * 0.1f;
+	player->weapon_offset.x += (player->weapon_dest_offset.x - player->weapon_offset.x) * offset_smoothing;
+	player->weapon_offset.y += (player->weapon_dest_offset.y - player->weapon_offset.y) * offset_smoothing;
+	player->weapon_offset.z += (player->weapon_dest_offset.z - player->weapon_offset.z) * offset_smoothing;
 
 	/* set actual camera position */
 	de_vec3_t combined_position;
@@ -333,37 +401,40 @@ static void player_update(actor_t* actor)
 
 	if (de_vec3_sqr_len(&direction) > 0) {
 		de_vec3_normalize(&direction, &direction);
-		player->path_len += 0.05f;
+		player->path_len += 0.05f * tick_scale;
 		if (player->path_len >= 1) {
+#ifndef SHOOTER_DEDICATED_SERVER
 			level_t* level = actor->parent_level;
 			for (size_t i = 0; i < de_body_get_contact_count(body); ++i) {
 				de_contact_t* contact = de_body_get_contact(body, i);
 				if (contact->triangle && contact->normal.y > 0.707) {
-					de_resource_t* res = footstep_sound_map_probe(&level->footstep_sound_map, contact->triangle->material_hash);
+					de_resource_t* res = footstep_sound_map_probe(&level->footstep_sound_map, contact->triangle->material_hash,
+						rng_streams_get(level->game->random, RNG_STREAM_FOOTSTEPS));
 					if (res) {
-						de_sound_buffer_t* buffer = de_resource_to_sound_buffer(res);
-						de_sound_context_t* ctx = de_core_get_sound_context(level->game->core);
-						de_sound_source_t* src = de_sound_source_create(ctx, DE_SOUND_SOURCE_TYPE_3D);
-						de_sound_source_set_buffer(src, buffer);
-						de_sound_source_set_play_once(src, true);
-						de_sound_source_play(src);
-						de_vec3_t pos;
-						de_node_get_global_position(pivot, &pos);
-						de_sound_source_set_position(src, &pos);
+						/* no sound pool in headless mode */
+						if (level->game->sound_pool) {
+							de_vec3_t pos;
+							de_node_get_global_position(pivot, &pos);
+							sound_pool_play(level->game->sound_pool, de_resource_to_sound_buffer(res), &pos, SOUND_PRIORITY_LOW);
+						}
 						break;
 					}
 				}
 			}
+#endif
 			player->path_len = 0;
 		}
 	}
 
-	player->yaw += (player->desired_yaw - player->yaw) * 0.22f;
-	player->pitch += (player->desired_pitch - player->pitch) * 0.22f;
+	const float look_smoothing = game_get_smoothing(game, 0.22f);
+	player->yaw += (player->desired_yaw - player->yaw) * look_smoothing;
+	player->pitch += (player->desired_pitch - player->pitch) * look_smoothing;
 
 	if (actor_has_ground_contact(actor)) {
-		de_body_set_x_velocity(body, direction.x * speed_multiplier * actor->move_speed);
-		de_body_set_z_velocity(body, direction.z * speed_multiplier * actor->move_speed);
+		/* move speed is distance per reference tick */
+		const float ground_speed = speed_multiplier * actor->move_speed * tick_scale;
+		de_body_set_x_velocity(body, direction.x * ground_speed);
+		de_body_set_z_velocity(body, direction.z * ground_speed);
 	} else {
 		/* a bit of air-control */
 		de_body_add_acceleration(body, &(de_vec3_t) {
@@ -384,42 +455,46 @@ static void player_update(actor_t* actor)
 	de_vec3_t camera_look;
 	de_node_get_look_vector(camera, &camera_look);
 
-	const de_ray_t laser_sight_ray = {
-		.origin = camera_global_position, .dir = { camera_look.x * 100, camera_look.y * 100, camera_look.z * 100 }
-	};
-
-	if (de_ray_cast(actor->parent_level->scene, &laser_sight_ray, DE_RAY_CAST_FLAGS_SORT_RESULTS, &player->ray_cast_list)) {
+	player_update_aim(player, &camera_global_position, &camera_look);
 
-		de_ray_cast_result_t* closest = NULL;
-		for(size_t i = 0; i < player->ray_cast_list.size; ++i) {
-			if(player->ray_cast_list.data[i].body != body) {
-				closest = &player->ray_cast_list.data[i];
-				break;
-			}
-		}
+	const player_aim_t* aim = &player->aim;
+	if (aim->hit_distance != FLT_MAX) {
+		de_vec3_t dot_offset;
+		de_vec3_normalize(&dot_offset, &aim->hit_normal);
+		de_vec3_scale(&dot_offset, &dot_offset, 0.2f);
 
-		if (closest) {
-			de_vec3_t dot_offset;
-			de_vec3_normalize(&dot_offset, &closest->normal);
-			de_vec3_scale(&dot_offset, &dot_offset, 0.2f);
+		de_vec3_t laser_dot_position;
+		de_vec3_add(&laser_dot_position, &aim->hit_position, &dot_offset);
+		de_node_set_local_position(player->laser_dot, &laser_dot_position);
 
-			de_vec3_t laser_dot_position;
-			de_vec3_add(&laser_dot_position, &closest->position, &dot_offset);
-			de_node_set_local_position(player->laser_dot, &laser_dot_position);
+		de_node_set_local_position(player->ray_cast_pick, &aim->hit_position);
+	}
 
-			de_node_set_local_position(player->ray_cast_pick, &closest->position);
+	/* after aim is updated, so shot goes where laser points and reuses its world hit */
+	if (player->controller.shoot) {
+		weapon_t* wpn = player_get_current_weapon(player);
+		if (wpn) {
+			weapon_shoot(wpn);
 		}
 	}
 
+#ifndef SHOOTER_DEDICATED_SERVER
 	/* listener */
 	de_sound_context_t* ctx = de_core_get_sound_context(actor->parent_level->game->core);
 	de_listener_t* lst = de_sound_context_get_listener(ctx);
 
 	de_listener_set_orientation(lst, &look, &(de_vec3_t) { 0, 1, 0 });
 	de_listener_set_position(lst, &camera_global_position);
+	if (actor->parent_level->game->sound_pool) {
+		sound_pool_set_listener_position(actor->parent_level->game->sound_pool, &camera_global_position);
+	}
 
-	weapon_t* wpn = player_get_current_weapon(player);
-	hud_update(actor->parent_level->game->hud, actor->health, wpn ? wpn->ammo : 0);
+	hud_t* hud = actor->parent_level->game->hud;
+	if (hud) {
+		weapon_t* wpn = player_get_current_weapon(player);
+		hud_update(hud, actor->health, wpn ? wpn->ammo : 0);
+	}
+#endif
 }
 
 actor_dispatch_table_t* player_get_dispatch_table()
@@ -427,7 +502,6 @@ actor_dispatch_table_t* player_get_dispatch_table()
 	static actor_dispatch_table_t table = {
 		.init = player_init,
 		.deinit = player_deinit,
-		.visit = player_visit,
 		.update = player_update,
 		.process_event = player_process_event,
 	};
@@ -436,6 +510,7 @@ actor_dispatch_table_t* player_get_dispatch_table()
 
 void player_add_weapon(player_t* player, weapon_t* wpn)
 {
+	wpn->owner = player->actor;
 	de_node_attach(wpn->model, player->weapon_pivot);
 	DE_ARRAY_APPEND(player->weapons, wpn);
 
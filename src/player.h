@@ -19,18 +19,51 @@
 * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
 * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+/**
+ * @brief Input of player for one tick. Events only change controller state, all
+ * actions happen in player_update, so controller (with desired yaw and pitch) is
+ * all replay needs to reproduce player.
+ */
 typedef struct player_controller_t {
 	bool move_forward;
 	bool move_backward;
 	bool strafe_left;
 	bool strafe_right;
 	bool crouch;
-	bool jumped;
+	bool jumped; /**< Jump key is held, so key repeat does not jump again. */
 	bool run;
 	bool shoot;
+	bool jump; /**< One-shot, cleared by player_update. */
+	bool throw_grenade; /**< One-shot, cleared by player_update. */
+	int weapon_switch; /**< Amount of weapons to switch forward (negative - backward), cleared by player_update. */
 } player_controller_t;
 
+#define PLAYER_LASER_SIGHT_RANGE 100.0f
+/* camera wobble and smoothing never settle bit-exactly, so cached world query of laser
+ * sight is reused while camera stays within these tolerances of cached ray; look
+ * tolerance is 1 cm of laser dot shift at full range */
+#define PLAYER_AIM_ORIGIN_TOLERANCE 0.001f
+#define PLAYER_AIM_LOOK_TOLERANCE (0.01f / PLAYER_LASER_SIGHT_RANGE)
+
+/**
+ * @brief Result of laser sight ray. Static world part is cached and queried again
+ * only when camera moves; actors are tested against their capsules every tick.
+ */
+typedef struct player_aim_t {
+	bool valid; /**< False until first query. */
+	de_vec3_t look; /**< Camera look vector of cached world query. */
+	de_ray_t ray; /**< From camera, length is PLAYER_LASER_SIGHT_RANGE. */
+	float world_hit_distance; /**< FLT_MAX if world was not hit. */
+	de_vec3_t world_hit_position;
+	de_vec3_t world_hit_normal;
+	float hit_distance; /**< Closest of world and actors, FLT_MAX if nothing was hit. */
+	de_vec3_t hit_position;
+	de_vec3_t hit_normal;
+	size_t world_query_count; /**< How many times world was actually queried. */
+} player_aim_t;
+
 struct player_t {
+	actor_t* actor;
 	de_node_t* camera;
 	de_node_t* flash_light;
 	de_node_t* weapon_pivot;
@@ -58,6 +91,7 @@ struct player_t {
 	player_controller_t controller;
 	de_node_t* laser_dot;
 	de_ray_cast_result_array_t ray_cast_list;
+	player_aim_t aim;
 };
 
 actor_dispatch_table_t* player_get_dispatch_table();
@@ -0,0 +1,228 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+profiler_t* profiler_create(void)
+{
+	profiler_t* profiler = DE_NEW(profiler_t);
+	profiler->frames[0].start_time = de_time_get_seconds();
+	return profiler;
+}
+
+void profiler_free(profiler_t* profiler)
+{
+	de_free(profiler);
+}
+
+const char* profiler_scope_name(profiler_scope_t scope)
+{
+	static const char* names[PROFILER_SCOPE_COUNT] = {
+		"Events",
+		"Sound",
+		"GUI",
+		"Scene",
+		"Level",
+		"  Items",
+		"  Actors",
+		"  Hitscan",
+		"  Projectiles",
+		"  Jump pads",
+		"Physics",
+		"Render"
+	};
+	if (scope < PROFILER_SCOPE_COUNT) {
+		return names[scope];
+	}
+	return "Frame";
+}
+
+void profiler_begin_frame(profiler_t* profiler)
+{
+	profiler_frame_t* frame = profiler->frames + profiler->current;
+	memset(frame, 0, offsetof(profiler_frame_t, events));
+	frame->start_time = de_time_get_seconds();
+}
+
+void profiler_end_frame(profiler_t* profiler)
+{
+	profiler_frame_t* frame = profiler->frames + profiler->current;
+	frame->duration = (float)(de_time_get_seconds() - frame->start_time);
+	profiler->current = (profiler->current + 1) % PROFILER_FRAME_HISTORY;
+	if (profiler->frame_count < PROFILER_FRAME_HISTORY) {
+		++profiler->frame_count;
+	}
+}
+
+void profiler_begin_scope(profiler_t* profiler, profiler_scope_t scope)
+{
+	DE_ASSERT(scope < PROFILER_SCOPE_COUNT);
+	profiler->scope_begin[scope] = de_time_get_seconds();
+}
+
+void profiler_end_scope(profiler_t* profiler, profiler_scope_t scope)
+{
+	DE_ASSERT(scope < PROFILER_SCOPE_COUNT);
+	const double end = de_time_get_seconds();
+	const double begin = profiler->scope_begin[scope];
+	profiler_frame_t* frame = profiler->frames + profiler->current;
+	frame->scope_time[scope] += (float)(end - begin);
+	/* if frame has too many events, only accumulated time will be available */
+	if (frame->event_count < PROFILER_MAX_EVENTS_PER_FRAME) {
+		profiler_event_t* evt = frame->events + frame->event_count++;
+		evt->scope = (uint8_t)scope;
+		evt->begin = (float)((begin - frame->start_time) * 1000000.0);
+		evt->duration = (float)((end - begin) * 1000000.0);
+	}
+}
+
+static const profiler_frame_t* profiler_get_frame(const profiler_t* profiler, size_t age)
+{
+	DE_ASSERT(age < profiler->frame_count);
+	return profiler->frames + (profiler->current + PROFILER_FRAME_HISTORY - 1 - age) % PROFILER_FRAME_HISTORY;
+}
+
+static float profiler_get_frame_value(const profiler_frame_t* frame, profiler_scope_t scope)
+{
+	return scope < PROFILER_SCOPE_COUNT ? frame->scope_time[scope] : frame->duration;
+}
+
+float profiler_get_last(profiler_t* profiler, profiler_scope_t scope)
+{
+	if (!profiler->frame_count) {
+		return 0.0f;
+	}
+	return profiler_get_frame_value(profiler_get_frame(profiler, 0), scope);
+}
+
+/**
+ * @brief Wirth's selection, returns k-th smallest element. Average O(n), which is
+ * cheap enough to do it every frame for whole history.
+ */
+static float profiler_select(float* values, int count, int k)
+{
+	int left = 0;
+	int right = count - 1;
+	while (left < right) {
+		const float pivot = values[k];
+		int i = left;
+		int j = right;
+		do {
+			while (values[i] < pivot) {
+				++i;
+			}
+			while (pivot < values[j]) {
+				--j;
+			}
+			if (i <= j) {
+				const float temp = values[i];
+				values[i] = values[j];
+				values[j] = temp;
+				++i;
+				--j;
+			}
+		} while (i <= j);
+		if (j < k) {
+			left = i;
+		}
+		if (k < i) {
+			right = j;
+		}
+	}
+	return values[k];
+}
+
+float profiler_get_percentile(profiler_t* profiler, profiler_scope_t scope, float percentile)
+{
+	const size_t count = profiler->frame_count;
+	if (!count) {
+		return 0.0f;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		profiler->scratch[i] = profiler_get_frame_value(profiler_get_frame(profiler, i), scope);
+	}
+	int k = (int)(percentile / 100.0f * (float)(count - 1) + 0.5f);
+	if (k >= (int)count) {
+		k = (int)count - 1;
+	}
+	return profiler_select(profiler->scratch, (int)count, k);
+}
+
+static float profiler_get_mean(profiler_t* profiler, profiler_scope_t scope)
+{
+	if (!profiler->frame_count) {
+		return 0.0f;
+	}
+	double sum = 0.0;
+	for (size_t i = 0; i < profiler->frame_count; ++i) {
+		sum += profiler_get_frame_value(profiler_get_frame(profiler, i), scope);
+	}
+	return (float)(sum / (double)profiler->frame_count);
+}
+
+void profiler_print(profiler_t* profiler, char* buffer, size_t buffer_size)
+{
+	size_t len = 0;
+	for (int scope = 0; scope <= PROFILER_SCOPE_COUNT && len < buffer_size; ++scope) {
+		const int written = snprintf(buffer + len, buffer_size - len, "%-14s %6.2f ms (mean %6.2f; p99 %6.2f)\n",
+			profiler_scope_name((profiler_scope_t)scope),
+			profiler_get_last(profiler, (profiler_scope_t)scope) * 1000.0f,
+			profiler_get_mean(profiler, (profiler_scope_t)scope) * 1000.0f,
+			profiler_get_percentile(profiler, (profiler_scope_t)scope, 99.0f) * 1000.0f);
+		if (written < 0) {
+			break;
+		}
+		len += (size_t)written;
+	}
+}
+
+bool profiler_dump_chrome_trace(profiler_t* profiler, const char* filename)
+{
+	FILE* file = fopen(filename, "w");
+	if (!file) {
+		de_log("profiler: unable to write %s", filename);
+		return false;
+	}
+	fprintf(file, "{\"traceEvents\":[\n");
+	bool first = true;
+	const double origin = profiler->frame_count ? profiler_get_frame(profiler, profiler->frame_count - 1)->start_time : 0.0;
+	/* oldest frame first */
+	for (size_t age = profiler->frame_count; age-- > 0; ) {
+		const profiler_frame_t* frame = profiler_get_frame(profiler, age);
+		const double frame_start = (frame->start_time - origin) * 1000000.0;
+		fprintf(file, "%s{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+			first ? "" : ",\n", frame_start, frame->duration * 1000000.0);
+		first = false;
+		for (size_t i = 0; i < frame->event_count; ++i) {
+			const profiler_event_t* evt = frame->events + i;
+			/* trim indentation used by overlay */
+			const char* name = profiler_scope_name((profiler_scope_t)evt->scope);
+			while (*name == ' ') {
+				++name;
+			}
+			fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"game\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+				name, frame_start + evt->begin, evt->duration);
+		}
+	}
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	de_log("profiler: %d frames written to %s", (int)profiler->frame_count, filename);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+/**
+ * @brief Subsystems measured by the profiler. Scopes may nest (level items
+ * inside of level), every scope may be entered many times per frame - time is
+ * accumulated.
+ */
+typedef enum profiler_scope_t {
+	PROFILER_SCOPE_EVENTS,
+	PROFILER_SCOPE_SOUND,
+	PROFILER_SCOPE_GUI,
+	PROFILER_SCOPE_SCENE,
+	PROFILER_SCOPE_LEVEL,
+	PROFILER_SCOPE_LEVEL_ITEMS,
+	PROFILER_SCOPE_LEVEL_ACTORS,
+	PROFILER_SCOPE_LEVEL_HITSCAN,
+	PROFILER_SCOPE_LEVEL_PROJECTILES,
+	PROFILER_SCOPE_LEVEL_JUMP_PADS,
+	PROFILER_SCOPE_PHYSICS,
+	PROFILER_SCOPE_RENDER,
+	PROFILER_SCOPE_COUNT
+} profiler_scope_t;
+
+#define PROFILER_FRAME_HISTORY 4096
+#define PROFILER_MAX_EVENTS_PER_FRAME 48
+
+typedef struct profiler_event_t {
+	uint8_t scope;
+	float begin; /**< Microseconds since frame start. */
+	float duration; /**< Microseconds. */
+} profiler_event_t;
+
+typedef struct profiler_frame_t {
+	double start_time; /**< Seconds. */
+	float duration; /**< Seconds. */
+	float scope_time[PROFILER_SCOPE_COUNT]; /**< Accumulated time of each scope in seconds. */
+	uint32_t event_count;
+	profiler_event_t events[PROFILER_MAX_EVENTS_PER_FRAME];
+} profiler_frame_t;
+
+/**
+ * @brief Ring buffer of last PROFILER_FRAME_HISTORY frames.
+ */
+struct profiler_t {
+	profiler_frame_t frames[PROFILER_FRAME_HISTORY];
+	size_t current; /**< Index of frame being recorded. */
+	size_t frame_count; /**< Amount of complete frames in ring, up to PROFILER_FRAME_HISTORY. */
+	double scope_begin[PROFILER_SCOPE_COUNT];
+	float scratch[PROFILER_FRAME_HISTORY]; /**< Temporary storage for percentile selection. */
+};
+
+profiler_t* profiler_create(void);
+
+void profiler_free(profiler_t* profiler);
+
+void profiler_begin_frame(profiler_t* profiler);
+
+void profiler_end_frame(profiler_t* profiler);
+
+void profiler_begin_scope(profiler_t* profiler, profiler_scope_t scope);
+
+void profiler_end_scope(profiler_t* profiler, profiler_scope_t scope);
+
+const char* profiler_scope_name(profiler_scope_t scope);
+
+/**
+ * @brief Returns time of scope in last complete frame in seconds.
+ * Pass PROFILER_SCOPE_COUNT to get whole frame time.
+ */
+float profiler_get_last(profiler_t* profiler, profiler_scope_t scope);
+
+/**
+ * @brief Returns percentile (0..100) of scope time over whole history in seconds.
+ * Pass PROFILER_SCOPE_COUNT to get percentile of whole frame time.
+ */
+float profiler_get_percentile(profiler_t* profiler, profiler_scope_t scope, float percentile);
+
+/**
+ * @brief Prints per-scope breakdown (last, mean and p99) into buffer.
+ */
+void profiler_print(profiler_t* profiler, char* buffer, size_t buffer_size);
+
+/**
+ * @brief Writes whole history in Chrome tracing format (chrome://tracing).
+ */
+bool profiler_dump_chrome_trace(profiler_t* profiler, const char* filename);
\ No newline at end of file
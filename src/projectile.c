@@ -23,57 +23,150 @@ static projectile_definition_t* projectile_get_definition(projectile_type_t type
 {
 	static projectile_definition_t rocket = {
 		.speed = 1.0f,
-		.model = "data/models/projectile/rocket.fbx",
+		.model = ASSET_MODEL_ROCKET,
 		.body_radius = 0.15f,
 		.need_body = true,
 		.flying = true,
-		.lifetime = 180,
+		.lifetime = 3.0f,
 	};
 	static projectile_definition_t grenade = {
 		.speed = 0.01f,
-		.model = "data/models/projectile/grenade.fbx",
+		.model = ASSET_MODEL_GRENADE,
 		.body_radius = 0.1f,
 		.need_body = true,
-		.lifetime = 90
+		.lifetime = 1.5f
 	};
 	switch (type) {
 		case PROJECTILE_TYPE_ROCKET:
 			return &rocket;
 		case PROJECTILE_TYPE_GRENADE:
 			return &grenade;
+		default:
+			break;
 	}
 	return NULL;
 }
 
-projectile_t* projectile_create(level_t* level, projectile_type_t type, const de_vec3_t* pos, const de_vec3_t* dir)
+/* parked projectiles wait here, far away from playable area */
+static const de_vec3_t projectile_park_position = { 0.0f, -10000.0f, 0.0f };
+/* same as gravity that engine gives to new bodies */
+static const de_vec3_t projectile_gravity = { 0.0f, -9.81f, 0.0f };
+
+/**
+ * @brief Bodies are not pooled: parked projectile must not take part in physics at all,
+ * so body is created on every spawn and freed on park. Node is the expensive part anyway.
+ */
+static void projectile_attach_body(projectile_t* p)
+{
+	if (p->definition->need_body) {
+		p->body = de_body_create(p->level->scene, de_convex_shape_create_sphere(p->definition->body_radius));
+		de_node_set_body(p->model, p->body);
+		de_body_set_gravity(p->body, &projectile_gravity);
+	}
+}
+
+static void projectile_detach_body(projectile_t* p)
+{
+	if (p->body) {
+		de_node_set_body(p->model, NULL);
+		de_body_free(p->body);
+		p->body = NULL;
+	}
+}
+
+static projectile_t* projectile_allocate(level_t* level, projectile_type_t type)
 {
 	projectile_t* p = DE_NEW(projectile_t);
 	p->level = level;
 	p->type = type;
-	de_vec3_normalize(&p->direction, dir);	
 	p->definition = projectile_get_definition(type);
-	de_path_t model_path;
-	de_path_from_cstr_as_view(&model_path, p->definition->model);
-	de_resource_t* res = de_core_request_resource(level->game->core, DE_RESOURCE_TYPE_MODEL, &model_path);
-	if (res) {
-		de_model_t* model = de_resource_to_model(res);
+	de_model_t* model = asset_registry_get_model(&level->assets, p->definition->model);
+	if (model) {
 		p->model = de_model_instantiate(model, level->scene);				
 	}
-	if (p->definition->need_body) {
-		de_body_t* body = de_body_create(level->scene, de_convex_shape_create_sphere(p->definition->body_radius));		
-		de_node_set_body(p->model, body);		
+	++level->projectile_pool.allocated_count;
+	return p;
+}
+
+projectile_t* projectile_create(level_t* level, projectile_type_t type, const de_vec3_t* pos, const de_vec3_t* dir)
+{
+	DE_ASSERT(type < PROJECTILE_TYPE_COUNT);
+	projectile_pool_t* pool = &level->projectile_pool;
+	if (pool->alive_count >= PROJECTILE_POOL_CAPACITY) {
+		/* list is in creation order, so head is the oldest one */
+		projectile_free(level->projectiles.head);
+	}
+
+	projectile_t* p = pool->parked[type].list.head;
+	if (p) {
+		DE_LINKED_LIST_REMOVE(pool->parked[type].list, p);
+		de_node_set_local_visibility(p->model, true);
+	} else {
+		p = projectile_allocate(level, type);
 	}
-	p->lifetime = p->definition->lifetime;
+	projectile_attach_body(p);
+	de_vec3_normalize(&p->direction, dir);	
+	projectile_set_lifetime(p, p->definition->lifetime);
 	de_node_set_local_position(p->model, pos);
 	DE_LINKED_LIST_APPEND(level->projectiles, p);
+
+	++pool->alive_count;
+	if (pool->alive_count > pool->high_water_mark) {
+		pool->high_water_mark = pool->alive_count;
+	}
 	return p;
 }
 
 void projectile_free(projectile_t* p)
 {
 	DE_ASSERT(p);
+	projectile_pool_t* pool = &p->level->projectile_pool;
 	DE_LINKED_LIST_REMOVE(p->level->projectiles, p);
-	de_free(p);
+	--pool->alive_count;
+	timer_wheel_cancel(&p->level->timers, &p->expiry_timer);
+
+	/* park it */
+	de_node_set_local_visibility(p->model, false);
+	de_node_set_local_position(p->model, &projectile_park_position);
+	projectile_detach_body(p);
+	DE_LINKED_LIST_APPEND(pool->parked[p->type].list, p);
+}
+
+void projectile_pool_free(level_t* level)
+{
+	projectile_pool_t* pool = &level->projectile_pool;
+	while (level->projectiles.head) {
+		projectile_t* p = level->projectiles.head;
+		DE_LINKED_LIST_REMOVE(level->projectiles, p);
+		de_free(p);
+	}
+	for (int type = 0; type < PROJECTILE_TYPE_COUNT; ++type) {
+		while (pool->parked[type].list.head) {
+			projectile_t* p = pool->parked[type].list.head;
+			DE_LINKED_LIST_REMOVE(pool->parked[type].list, p);
+			de_free(p);
+		}
+	}
+	de_log("projectiles: %d allocated, %d alive at most", (int)pool->allocated_count, (int)pool->high_water_mark);
+	pool->alive_count = 0;
+}
+
+static void projectile_on_expiry(game_timer_t* timer, void* user_data)
+{
+	DE_UNUSED(timer);
+	projectile_free(user_data);
+}
+
+float projectile_get_lifetime(const projectile_t* p)
+{
+	const uint64_t ticks = timer_wheel_get_remaining(&p->level->timers, &p->expiry_timer);
+	return (float)((double)ticks * p->level->game->time.delta);
+}
+
+void projectile_set_lifetime(projectile_t* p, float lifetime)
+{
+	const uint64_t ticks = timer_wheel_ticks_from_seconds(lifetime, p->level->game->time.delta);
+	timer_wheel_schedule(&p->level->timers, &p->expiry_timer, ticks ? ticks : 1, projectile_on_expiry, p);
 }
 
 void projectile_update(projectile_t* p)
@@ -81,8 +174,8 @@ void projectile_update(projectile_t* p)
 	DE_ASSERT(p);	
 	if (p->definition->flying) {
 		de_vec3_t velocity;
-		de_vec3_scale(&velocity, &p->direction, p->definition->speed);
+		/* speed is distance per tick of GAME_REFERENCE_TICK_RATE */
+		de_vec3_scale(&velocity, &p->direction, p->definition->speed * game_get_tick_scale(p->level->game));
 		de_node_move(p->model, &velocity);
 	}
-	--p->lifetime;	
 }
\ No newline at end of file
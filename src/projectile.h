@@ -19,18 +19,21 @@
 * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
 * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#define PROJECTILE_POOL_CAPACITY 64
+
 typedef enum projectile_type_t {
 	PROJECTILE_TYPE_ROCKET,
 	PROJECTILE_TYPE_GRENADE,
+	PROJECTILE_TYPE_COUNT,
 } projectile_type_t;
 
 typedef struct projectile_definition_t {	
 	float speed;
 	bool need_body;
 	bool flying;
-	int lifetime;
+	float lifetime; /**< Seconds, converted to ticks of level timer wheel on creation. */
 	float body_radius;
-	const char* model;
+	asset_id_t model;
 } projectile_definition_t;
 
 typedef struct projectile_t {
@@ -38,13 +41,49 @@ typedef struct projectile_t {
 	projectile_type_t type;
 	projectile_definition_t* definition;
 	de_node_t* model;
+	de_body_t* body; /**< NULL if definition does not need body. */
 	de_vec3_t direction;
-	int lifetime;
+	game_timer_t expiry_timer; /**< Frees projectile when its lifetime is over. */
 	DE_LINKED_LIST_ITEM(struct projectile_t);
 } projectile_t;
 
+/**
+ * @brief Recycles projectiles together with their scene nodes. Expired projectiles
+ * are parked (hidden, moved away, body removed) in per-type list and reused
+ * by next projectile_create of same type. At most PROJECTILE_POOL_CAPACITY
+ * projectiles are alive at once, oldest one is recycled when limit is reached.
+ */
+typedef struct projectile_pool_t {
+	struct {
+		DE_LINKED_LIST_DECLARE(struct projectile_t, list);
+	} parked[PROJECTILE_TYPE_COUNT];
+	size_t alive_count;
+	size_t high_water_mark; /**< Max amount of projectiles alive at once. */
+	size_t allocated_count; /**< Total amount of projectiles (with nodes) ever created. */
+} projectile_pool_t;
+
 projectile_t* projectile_create(level_t* level, projectile_type_t type, const de_vec3_t* pos, const de_vec3_t* dir);
 
+/**
+ * @brief Returns projectile to pool of its level, node is kept for reuse, body is freed.
+ */
 void projectile_free(projectile_t* p);
 
-void projectile_update(projectile_t* p);
\ No newline at end of file
+/**
+ * @brief Frees every projectile of level, alive or parked. Nodes and bodies are
+ * owned by scene, so this must be called before scene is freed.
+ */
+void projectile_pool_free(level_t* level);
+
+void projectile_update(projectile_t* p);
+
+/**
+ * @brief Returns time in seconds left until projectile is freed.
+ */
+float projectile_get_lifetime(const projectile_t* p);
+
+/**
+ * @brief Schedules expiry of projectile, lifetime is in seconds and converted to ticks
+ * of current tick rate, so saves do not depend on tick rate.
+ */
+void projectile_set_lifetime(projectile_t* p, float lifetime);
\ No newline at end of file
@@ -0,0 +1,142 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+#define RAY_CAPSULE_EPSILON 1e-12f
+
+/* Vector and scalar paths below do exactly same float operations in same
+ * order, so results are equal bit-for-bit as long as compiler does not fuse
+ * multiply-add (it does not in ISO C mode). Keep them in sync! */
+
+float ray_capsule_intersect(const de_ray_t* ray, float x, float y, float z, float half_height, float radius)
+{
+	const float dx = ray->dir.x, dy = ray->dir.y, dz = ray->dir.z;
+	const float ox = ray->origin.x - x;
+	const float oy = ray->origin.y - y;
+	const float oz = ray->origin.z - z;
+	const float r2 = radius * radius;
+
+	/* side of infinite cylinder, valid only between centers of caps */
+	const float a_xz = dx * dx + dz * dz;
+	const float b_xz = ox * dx + oz * dz;
+	const float xz2 = ox * ox + oz * oz;
+	const float c_xz = xz2 - r2;
+	const float disc_xz = b_xz * b_xz - a_xz * c_xz;
+	const float safe_a_xz = a_xz > RAY_CAPSULE_EPSILON ? a_xz : RAY_CAPSULE_EPSILON;
+	const float t_cyl = (-b_xz - sqrtf(disc_xz > 0.0f ? disc_xz : 0.0f)) / safe_a_xz;
+	const float y_cyl = oy + t_cyl * dy;
+	float t = (disc_xz >= 0.0f && a_xz > RAY_CAPSULE_EPSILON && y_cyl <= half_height && y_cyl >= -half_height) ? t_cyl : FLT_MAX;
+
+	/* caps: first entry into capsule is closest of entries into cylinder and spheres */
+	const float a = a_xz + dy * dy;
+	for (int i = 0; i < 2; ++i) {
+		const float my = i == 0 ? oy - half_height : oy + half_height;
+		const float b = b_xz + my * dy;
+		const float c = xz2 + my * my - r2;
+		const float disc = b * b - a * c;
+		const float t_sphere = (-b - sqrtf(disc > 0.0f ? disc : 0.0f)) / a;
+		t = (disc >= 0.0f && t_sphere < t) ? t_sphere : t;
+	}
+
+	return (t >= 0.0f && t <= 1.0f) ? t : FLT_MAX;
+}
+
+void ray_capsule_intersect_many_scalar(const de_ray_t* ray, const ray_capsule_soa_t* capsules, float* out_t)
+{
+	for (size_t i = 0; i < capsules->count; ++i) {
+		out_t[i] = ray_capsule_intersect(ray, capsules->x[i], capsules->y[i], capsules->z[i], capsules->half_height[i], capsules->radius[i]);
+	}
+}
+
+#ifdef RAY_CAPSULE_SSE2
+static __m128 ray_capsule_select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/* flips sign bit exactly like unary minus, 0 - x would turn -0 into +0 */
+static __m128 ray_capsule_negate(__m128 v)
+{
+	return _mm_xor_ps(v, _mm_set1_ps(-0.0f));
+}
+
+static __m128 ray_capsule_sphere(__m128 t, __m128 my, __m128 a, __m128 b_xz, __m128 xz2, __m128 r2, __m128 dy)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 b = _mm_add_ps(b_xz, _mm_mul_ps(my, dy));
+	const __m128 c = _mm_sub_ps(_mm_add_ps(xz2, _mm_mul_ps(my, my)), r2);
+	const __m128 disc = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, c));
+	const __m128 t_sphere = _mm_div_ps(_mm_sub_ps(ray_capsule_negate(b), _mm_sqrt_ps(_mm_max_ps(disc, zero))), a);
+	const __m128 valid = _mm_and_ps(_mm_cmpge_ps(disc, zero), _mm_cmplt_ps(t_sphere, t));
+	return ray_capsule_select(valid, t_sphere, t);
+}
+#endif
+
+void ray_capsule_intersect_many(const de_ray_t* ray, const ray_capsule_soa_t* capsules, float* out_t)
+{
+	size_t i = 0;
+#ifdef RAY_CAPSULE_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 no_hit = _mm_set1_ps(FLT_MAX);
+	const __m128 epsilon = _mm_set1_ps(RAY_CAPSULE_EPSILON);
+	const __m128 dx = _mm_set1_ps(ray->dir.x);
+	const __m128 dy = _mm_set1_ps(ray->dir.y);
+	const __m128 dz = _mm_set1_ps(ray->dir.z);
+	const __m128 origin_x = _mm_set1_ps(ray->origin.x);
+	const __m128 origin_y = _mm_set1_ps(ray->origin.y);
+	const __m128 origin_z = _mm_set1_ps(ray->origin.z);
+	/* same for every capsule */
+	const __m128 a_xz = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz));
+	const __m128 a = _mm_add_ps(a_xz, _mm_mul_ps(dy, dy));
+	const __m128 safe_a_xz = _mm_max_ps(a_xz, epsilon);
+	const __m128 a_xz_valid = _mm_cmpgt_ps(a_xz, epsilon);
+	for (; i + 4 <= capsules->count; i += 4) {
+		const __m128 half_height = _mm_loadu_ps(capsules->half_height + i);
+		const __m128 radius = _mm_loadu_ps(capsules->radius + i);
+		const __m128 ox = _mm_sub_ps(origin_x, _mm_loadu_ps(capsules->x + i));
+		const __m128 oy = _mm_sub_ps(origin_y, _mm_loadu_ps(capsules->y + i));
+		const __m128 oz = _mm_sub_ps(origin_z, _mm_loadu_ps(capsules->z + i));
+		const __m128 r2 = _mm_mul_ps(radius, radius);
+
+		const __m128 b_xz = _mm_add_ps(_mm_mul_ps(ox, dx), _mm_mul_ps(oz, dz));
+		const __m128 xz2 = _mm_add_ps(_mm_mul_ps(ox, ox), _mm_mul_ps(oz, oz));
+		const __m128 c_xz = _mm_sub_ps(xz2, r2);
+		const __m128 disc_xz = _mm_sub_ps(_mm_mul_ps(b_xz, b_xz), _mm_mul_ps(a_xz, c_xz));
+		const __m128 t_cyl = _mm_div_ps(_mm_sub_ps(ray_capsule_negate(b_xz), _mm_sqrt_ps(_mm_max_ps(disc_xz, zero))), safe_a_xz);
+		const __m128 y_cyl = _mm_add_ps(oy, _mm_mul_ps(t_cyl, dy));
+		__m128 valid = _mm_and_ps(_mm_cmpge_ps(disc_xz, zero), a_xz_valid);
+		valid = _mm_and_ps(valid, _mm_cmple_ps(y_cyl, half_height));
+		valid = _mm_and_ps(valid, _mm_cmpge_ps(y_cyl, ray_capsule_negate(half_height)));
+		__m128 t = ray_capsule_select(valid, t_cyl, no_hit);
+
+		t = ray_capsule_sphere(t, _mm_sub_ps(oy, half_height), a, b_xz, xz2, r2, dy);
+		t = ray_capsule_sphere(t, _mm_add_ps(oy, half_height), a, b_xz, xz2, r2, dy);
+
+		const __m128 in_ray = _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmple_ps(t, one));
+		_mm_storeu_ps(out_t + i, ray_capsule_select(in_ray, t, no_hit));
+	}
+#endif
+	/* tail (or everything if there is no SSE2) */
+	for (; i < capsules->count; ++i) {
+		out_t[i] = ray_capsule_intersect(ray, capsules->x[i], capsules->y[i], capsules->z[i], capsules->half_height[i], capsules->radius[i]);
+	}
+}
\ No newline at end of file
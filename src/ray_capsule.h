@@ -0,0 +1,55 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+/* SSE2 is baseline on x86-64, so vector kernel needs no extra compiler flags */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAY_CAPSULE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Vertical (Y axis) capsules in structure-of-arrays layout. Capsule is
+ * segment from (x, y - half_height, z) to (x, y + half_height, z) inflated by radius.
+ */
+typedef struct ray_capsule_soa_t {
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* half_height;
+	const float* radius;
+	size_t count;
+} ray_capsule_soa_t;
+
+/**
+ * @brief Returns fraction of ray (0..1, direction is scaled by length of ray) to
+ * first intersection with capsule, or FLT_MAX if ray does not enter capsule.
+ */
+float ray_capsule_intersect(const de_ray_t* ray, float x, float y, float z, float half_height, float radius);
+
+/**
+ * @brief Tests one ray against every capsule, writes fraction of ray (or FLT_MAX)
+ * per capsule. Uses SSE2 for four capsules at a time when available; results are
+ * bit-identical with ray_capsule_intersect_many_scalar.
+ */
+void ray_capsule_intersect_many(const de_ray_t* ray, const ray_capsule_soa_t* capsules, float* out_t);
+
+void ray_capsule_intersect_many_scalar(const de_ray_t* ray, const ray_capsule_soa_t* capsules, float* out_t);
\ No newline at end of file
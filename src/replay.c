@@ -0,0 +1,234 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+
+static uint16_t replay_pack_buttons(const player_controller_t* controller)
+{
+	return (uint16_t)(
+		(controller->move_forward ? 1 << 0 : 0) |
+		(controller->move_backward ? 1 << 1 : 0) |
+		(controller->strafe_left ? 1 << 2 : 0) |
+		(controller->strafe_right ? 1 << 3 : 0) |
+		(controller->crouch ? 1 << 4 : 0) |
+		(controller->jumped ? 1 << 5 : 0) |
+		(controller->run ? 1 << 6 : 0) |
+		(controller->shoot ? 1 << 7 : 0) |
+		(controller->jump ? 1 << 8 : 0) |
+		(controller->throw_grenade ? 1 << 9 : 0));
+}
+
+static void replay_unpack_buttons(player_controller_t* controller, uint16_t buttons)
+{
+	controller->move_forward = (buttons & (1 << 0)) != 0;
+	controller->move_backward = (buttons & (1 << 1)) != 0;
+	controller->strafe_left = (buttons & (1 << 2)) != 0;
+	controller->strafe_right = (buttons & (1 << 3)) != 0;
+	controller->crouch = (buttons & (1 << 4)) != 0;
+	controller->jumped = (buttons & (1 << 5)) != 0;
+	controller->run = (buttons & (1 << 6)) != 0;
+	controller->shoot = (buttons & (1 << 7)) != 0;
+	controller->jump = (buttons & (1 << 8)) != 0;
+	controller->throw_grenade = (buttons & (1 << 9)) != 0;
+}
+
+static void replay_write_u8(savegame_buffer_t* buffer, uint8_t value)
+{
+	savegame_write_bytes(buffer, &value, sizeof(value));
+}
+
+static uint8_t replay_read_u8(savegame_buffer_t* buffer)
+{
+	uint8_t value;
+	savegame_read_bytes(buffer, &value, sizeof(value));
+	return value;
+}
+
+static void replay_write_u16(savegame_buffer_t* buffer, uint16_t value)
+{
+	const uint8_t bytes[2] = { (uint8_t)value, (uint8_t)(value >> 8) };
+	savegame_write_bytes(buffer, bytes, sizeof(bytes));
+}
+
+static uint16_t replay_read_u16(savegame_buffer_t* buffer)
+{
+	uint8_t bytes[2];
+	savegame_read_bytes(buffer, bytes, sizeof(bytes));
+	return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+replay_t* replay_create_recorder(const char* path, const char* map_path, double tick_rate, uint32_t seed)
+{
+	replay_t* replay = DE_NEW(replay_t);
+	replay->mode = REPLAY_MODE_RECORD;
+	snprintf(replay->path, sizeof(replay->path), "%s", path);
+	snprintf(replay->map_path, sizeof(replay->map_path), "%s", map_path);
+	replay->tick_rate = (float)tick_rate;
+	replay->seed = seed;
+	savegame_buffer_init(&replay->stream);
+	return replay;
+}
+
+replay_t* replay_open(const char* path)
+{
+	savegame_buffer_t buffer;
+	savegame_buffer_init(&buffer);
+	if (!savegame_buffer_read_file(path, &buffer)) {
+		de_log("replay: unable to read %s", path);
+		savegame_buffer_free(&buffer);
+		return NULL;
+	}
+
+	replay_t* replay = DE_NEW(replay_t);
+	replay->mode = REPLAY_MODE_PLAY;
+	snprintf(replay->path, sizeof(replay->path), "%s", path);
+	const uint32_t magic = savegame_read_u32(&buffer);
+	const uint32_t version = savegame_read_u32(&buffer);
+	replay->tick_count = savegame_read_u32(&buffer);
+	replay->seed = savegame_read_u32(&buffer);
+	replay->tick_rate = savegame_read_f32(&buffer);
+	savegame_read_string(&buffer, replay->map_path, sizeof(replay->map_path));
+	if (buffer.read_error || magic != REPLAY_MAGIC || version != REPLAY_VERSION) {
+		de_log("replay: %s is not a valid replay file", path);
+		savegame_buffer_free(&buffer);
+		de_free(replay);
+		return NULL;
+	}
+
+	/* records are read sequentially from the rest of file */
+	replay->stream = buffer;
+	de_log("replay: %s - %d ticks at %.1f Hz on %s", path, (int)replay->tick_count, replay->tick_rate, replay->map_path);
+	return replay;
+}
+
+void replay_begin(replay_t* replay, level_t* level)
+{
+	/* weapons compare time of shots, so clock starts from zero in both recorded and played session */
+	level->game->time.seconds = 0.0;
+	rng_streams_reseed(level->game->random, replay->seed);
+	replay->started = true;
+}
+
+static void replay_record(replay_t* replay, const player_t* player)
+{
+	const player_controller_t* controller = &player->controller;
+	const uint16_t buttons = replay_pack_buttons(controller);
+
+	uint8_t flags = 0;
+	if (replay->tick_count == 0 || buttons != replay_pack_buttons(&replay->last_controller)) {
+		flags |= REPLAY_RECORD_BUTTONS;
+	}
+	if (replay->tick_count == 0 || player->desired_yaw != replay->last_yaw || player->desired_pitch != replay->last_pitch) {
+		flags |= REPLAY_RECORD_LOOK;
+	}
+	if (controller->weapon_switch != 0) {
+		flags |= REPLAY_RECORD_WEAPON_SWITCH;
+	}
+
+	replay_write_u8(&replay->stream, flags);
+	if (flags & REPLAY_RECORD_BUTTONS) {
+		replay_write_u16(&replay->stream, buttons);
+	}
+	if (flags & REPLAY_RECORD_LOOK) {
+		savegame_write_f32(&replay->stream, player->desired_yaw);
+		savegame_write_f32(&replay->stream, player->desired_pitch);
+	}
+	if (flags & REPLAY_RECORD_WEAPON_SWITCH) {
+		replay_write_u8(&replay->stream, (uint8_t)(int8_t)controller->weapon_switch);
+	}
+
+	replay->last_controller = *controller;
+	replay->last_yaw = player->desired_yaw;
+	replay->last_pitch = player->desired_pitch;
+	++replay->tick_count;
+}
+
+static void replay_play(replay_t* replay, player_t* player)
+{
+	savegame_buffer_t* stream = &replay->stream;
+	const uint8_t flags = replay_read_u8(stream);
+	if (flags & REPLAY_RECORD_BUTTONS) {
+		replay_unpack_buttons(&replay->last_controller, replay_read_u16(stream));
+	}
+	if (flags & REPLAY_RECORD_LOOK) {
+		replay->last_yaw = savegame_read_f32(stream);
+		replay->last_pitch = savegame_read_f32(stream);
+	}
+	player->controller = replay->last_controller;
+	player->controller.weapon_switch = (flags & REPLAY_RECORD_WEAPON_SWITCH) ? (int8_t)replay_read_u8(stream) : 0;
+	player->desired_yaw = replay->last_yaw;
+	player->desired_pitch = replay->last_pitch;
+
+	if (stream->read_error) {
+		de_log("replay: %s is truncated at tick %d", replay->path, (int)replay->tick);
+		replay->tick = replay->tick_count;
+		return;
+	}
+	++replay->tick;
+}
+
+void replay_tick(replay_t* replay, level_t* level)
+{
+	if (!replay->started || !level->player || replay_is_finished(replay)) {
+		return;
+	}
+	player_t* player = actor_to_player(level->player);
+	if (replay->mode == REPLAY_MODE_RECORD) {
+		replay_record(replay, player);
+	} else {
+		replay_play(replay, player);
+	}
+}
+
+bool replay_is_finished(const replay_t* replay)
+{
+	return replay->mode == REPLAY_MODE_PLAY && replay->tick >= replay->tick_count;
+}
+
+void replay_free(replay_t* replay)
+{
+	if (replay->mode == REPLAY_MODE_RECORD && replay->started) {
+		savegame_buffer_t header;
+		savegame_buffer_init(&header);
+		savegame_write_u32(&header, REPLAY_MAGIC);
+		savegame_write_u32(&header, REPLAY_VERSION);
+		savegame_write_u32(&header, replay->tick_count);
+		savegame_write_u32(&header, replay->seed);
+		savegame_write_f32(&header, replay->tick_rate);
+		savegame_write_string(&header, replay->map_path);
+
+		bool result = false;
+		FILE* file = fopen(replay->path, "wb");
+		if (file) {
+			result = fwrite(header.data, 1, header.size, file) == header.size;
+			result &= fwrite(replay->stream.data, 1, replay->stream.size, file) == replay->stream.size;
+			result &= fclose(file) == 0;
+		}
+		if (result) {
+			de_log("replay: %d ticks recorded to %s (%d bytes)", (int)replay->tick_count, replay->path, (int)(header.size + replay->stream.size));
+		} else {
+			de_log("replay: unable to write %s", replay->path);
+		}
+		savegame_buffer_free(&header);
+	}
+	savegame_buffer_free(&replay->stream);
+	de_free(replay);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+
+/* Replay stream layout (little-endian, same primitives as saves):
+ *   header: magic, version, tick count, seed (uint32 each), tick rate (float), map path (string)
+ *   one record per tick: flags byte, then fields whose flag is set:
+ *     REPLAY_RECORD_BUTTONS - uint16 mask of controller buttons
+ *     REPLAY_RECORD_LOOK - desired yaw and pitch (float each)
+ *     REPLAY_RECORD_WEAPON_SWITCH - int8 weapon switch
+ * Only changes are stored, so tick with unchanged input takes one byte. */
+
+#define REPLAY_MAGIC 0x50524853u /* "SHRP" */
+#define REPLAY_VERSION 1u
+
+typedef enum replay_record_flags_t {
+	REPLAY_RECORD_BUTTONS = 1 << 0,
+	REPLAY_RECORD_LOOK = 1 << 1,
+	REPLAY_RECORD_WEAPON_SWITCH = 1 << 2,
+} replay_record_flags_t;
+
+typedef enum replay_mode_t {
+	REPLAY_MODE_RECORD,
+	REPLAY_MODE_PLAY,
+} replay_mode_t;
+
+/**
+ * @brief Lockstep input stream of one session. Simulation is deterministic for
+ * given map, tick rate, seed and per-tick input of player, so that is all that is
+ * recorded; replay feeds recorded input back tick by tick instead of events.
+ */
+typedef struct replay_t {
+	replay_mode_t mode;
+	char path[LEVEL_MAP_PATH_MAX];
+	char map_path[LEVEL_MAP_PATH_MAX];
+	float tick_rate;
+	uint32_t seed;
+	uint32_t tick_count; /**< Recorded ticks, or total ticks of stream when playing. */
+	uint32_t tick; /**< Next tick to play. */
+	bool started; /**< Set by replay_begin, ticks are ignored until level is ready. */
+	savegame_buffer_t stream; /**< Records, without header. */
+	player_controller_t last_controller; /**< Last recorded or played state, records are deltas from it. */
+	float last_yaw;
+	float last_pitch;
+} replay_t;
+
+/**
+ * @brief Creates recorder, stream is written to path by replay_free.
+ */
+replay_t* replay_create_recorder(const char* path, const char* map_path, double tick_rate, uint32_t seed);
+
+/**
+ * @brief Reads whole replay file, returns NULL if file is missing or broken.
+ */
+replay_t* replay_open(const char* path);
+
+/**
+ * @brief Starts replay on freshly created level: seeds randomness of game with seed of replay.
+ */
+void replay_begin(replay_t* replay, level_t* level);
+
+/**
+ * @brief Records input of player or overwrites it with recorded one. Call once per tick
+ * after events are processed and before level is updated.
+ */
+void replay_tick(replay_t* replay, level_t* level);
+
+/**
+ * @brief Returns true when every tick of played stream was fed to player.
+ */
+bool replay_is_finished(const replay_t* replay);
+
+/**
+ * @brief Writes stream of recorder to file, then frees replay.
+ */
+void replay_free(replay_t* replay);
\ No newline at end of file
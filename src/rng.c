@@ -0,0 +1,105 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+
+static uint64_t rng_splitmix64(uint64_t* state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+static uint32_t rng_rotl(uint32_t x, int k)
+{
+	return (x << k) | (x >> (32 - k));
+}
+
+void rng_seed(rng_t* rng, uint64_t seed)
+{
+	/* state is expanded by splitmix64 as recommended by authors of xoshiro, it is never all zeros */
+	uint64_t state = seed;
+	const uint64_t a = rng_splitmix64(&state);
+	const uint64_t b = rng_splitmix64(&state);
+	rng->s[0] = (uint32_t)a;
+	rng->s[1] = (uint32_t)(a >> 32);
+	rng->s[2] = (uint32_t)b;
+	rng->s[3] = (uint32_t)(b >> 32);
+}
+
+uint32_t rng_next(rng_t* rng)
+{
+	uint32_t* s = rng->s;
+	const uint32_t result = rng_rotl(s[1] * 5, 7) * 9;
+	const uint32_t t = s[1] << 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rng_rotl(s[3], 11);
+	return result;
+}
+
+float rng_next_float(rng_t* rng)
+{
+	/* 24 bits is all float mantissa can hold */
+	return (float)(rng_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+uint32_t rng_next_below(rng_t* rng, uint32_t count)
+{
+	DE_ASSERT(count > 0);
+	/* multiply-shift instead of modulo: no division and no bias towards low numbers */
+	return (uint32_t)(((uint64_t)rng_next(rng) * count) >> 32);
+}
+
+static uint64_t rng_streams_derive_seed(uint32_t seed, uint32_t index)
+{
+	return ((uint64_t)index << 32) | seed;
+}
+
+rng_streams_t* rng_streams_create(uint32_t seed)
+{
+	rng_streams_t* streams = DE_NEW(rng_streams_t);
+	rng_streams_reseed(streams, seed);
+	return streams;
+}
+
+void rng_streams_reseed(rng_streams_t* streams, uint32_t seed)
+{
+	streams->seed = seed;
+	for (int i = 0; i < RNG_STREAM_COUNT; ++i) {
+		rng_seed(&streams->streams[i], rng_streams_derive_seed(seed, (uint32_t)i));
+	}
+}
+
+void rng_streams_free(rng_streams_t* streams)
+{
+	de_free(streams);
+}
+
+rng_t* rng_streams_get(rng_streams_t* streams, rng_stream_t stream)
+{
+	DE_ASSERT(stream >= 0 && stream < RNG_STREAM_COUNT);
+	return &streams->streams[stream];
+}
\ No newline at end of file
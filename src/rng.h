@@ -0,0 +1,72 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+
+/**
+ * @brief xoshiro128** generator. Small state, a few instructions per number and,
+ * unlike rand(), same sequence on every platform for same seed. Not thread-safe,
+ * each thread must use its own generator.
+ */
+typedef struct rng_t {
+	uint32_t s[4];
+} rng_t;
+
+void rng_seed(rng_t* rng, uint64_t seed);
+
+uint32_t rng_next(rng_t* rng);
+
+/**
+ * @brief Returns number in [0; 1) range.
+ */
+float rng_next_float(rng_t* rng);
+
+/**
+ * @brief Returns number in [0; count) range, count must be greater than zero.
+ */
+uint32_t rng_next_below(rng_t* rng, uint32_t count);
+
+/**
+ * @brief Independent streams of game randomness. Each subsystem draws only from its
+ * own stream, so adding random calls to one subsystem does not change sequences of
+ * others. Streams are used from main thread only: which worker runs a job depends on
+ * scheduling, so streams of jobs would have to be keyed by job, not by thread.
+ */
+typedef enum rng_stream_t {
+	RNG_STREAM_FOOTSTEPS,
+	RNG_STREAM_COUNT,
+} rng_stream_t;
+
+struct rng_streams_t {
+	uint32_t seed; /**< All streams are derived from it. */
+	rng_t streams[RNG_STREAM_COUNT];
+};
+
+rng_streams_t* rng_streams_create(uint32_t seed);
+
+void rng_streams_free(rng_streams_t* streams);
+
+/**
+ * @brief Restarts every stream from new seed.
+ */
+void rng_streams_reseed(rng_streams_t* streams, uint32_t seed);
+
+rng_t* rng_streams_get(rng_streams_t* streams, rng_stream_t stream);
\ No newline at end of file
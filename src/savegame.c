@@ -0,0 +1,580 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+void savegame_buffer_init(savegame_buffer_t* buffer)
+{
+	memset(buffer, 0, sizeof(*buffer));
+}
+
+void savegame_buffer_free(savegame_buffer_t* buffer)
+{
+	if (buffer->data) {
+		de_free(buffer->data);
+	}
+	memset(buffer, 0, sizeof(*buffer));
+}
+
+bool savegame_buffer_read_file(const char* path, savegame_buffer_t* buffer)
+{
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		return false;
+	}
+	bool result = false;
+	if (fseek(file, 0, SEEK_END) == 0) {
+		const long size = ftell(file);
+		if (size > 0 && fseek(file, 0, SEEK_SET) == 0) {
+			buffer->data = de_malloc((size_t)size);
+			buffer->capacity = (size_t)size;
+			buffer->size = fread(buffer->data, 1, (size_t)size, file);
+			result = buffer->size == (size_t)size;
+		}
+	}
+	fclose(file);
+	return result;
+}
+
+static void savegame_buffer_reserve(savegame_buffer_t* buffer, size_t capacity)
+{
+	if (buffer->capacity < capacity) {
+		buffer->capacity = capacity * 2;
+		buffer->data = de_realloc(buffer->data, buffer->capacity);
+	}
+}
+
+void savegame_write_bytes(savegame_buffer_t* buffer, const void* data, size_t size)
+{
+	savegame_buffer_reserve(buffer, buffer->size + size);
+	memcpy(buffer->data + buffer->size, data, size);
+	buffer->size += size;
+}
+
+void savegame_write_u32(savegame_buffer_t* buffer, uint32_t value)
+{
+	const uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+	savegame_write_bytes(buffer, bytes, sizeof(bytes));
+}
+
+void savegame_write_f32(savegame_buffer_t* buffer, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	savegame_write_u32(buffer, bits);
+}
+
+void savegame_write_vec3(savegame_buffer_t* buffer, const de_vec3_t* v)
+{
+	savegame_write_f32(buffer, v->x);
+	savegame_write_f32(buffer, v->y);
+	savegame_write_f32(buffer, v->z);
+}
+
+void savegame_write_string(savegame_buffer_t* buffer, const char* str)
+{
+	const size_t len = strlen(str);
+	savegame_write_u32(buffer, (uint32_t)len);
+	savegame_write_bytes(buffer, str, len);
+}
+
+bool savegame_read_bytes(savegame_buffer_t* buffer, void* data, size_t size)
+{
+	if (buffer->read_error || buffer->read_pos + size > buffer->size) {
+		buffer->read_error = true;
+		memset(data, 0, size);
+		return false;
+	}
+	memcpy(data, buffer->data + buffer->read_pos, size);
+	buffer->read_pos += size;
+	return true;
+}
+
+uint32_t savegame_read_u32(savegame_buffer_t* buffer)
+{
+	uint8_t bytes[4];
+	savegame_read_bytes(buffer, bytes, sizeof(bytes));
+	return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+float savegame_read_f32(savegame_buffer_t* buffer)
+{
+	const uint32_t bits = savegame_read_u32(buffer);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+void savegame_read_vec3(savegame_buffer_t* buffer, de_vec3_t* v)
+{
+	v->x = savegame_read_f32(buffer);
+	v->y = savegame_read_f32(buffer);
+	v->z = savegame_read_f32(buffer);
+}
+
+void savegame_read_string(savegame_buffer_t* buffer, char* str, size_t max_len)
+{
+	const uint32_t len = savegame_read_u32(buffer);
+	if (len >= max_len) {
+		buffer->read_error = true;
+		str[0] = '\0';
+		return;
+	}
+	savegame_read_bytes(buffer, str, len);
+	str[len] = '\0';
+}
+
+/**
+ * @brief Overwrites u32 at given position, used to patch section table.
+ */
+static void savegame_patch_u32(savegame_buffer_t* buffer, size_t pos, uint32_t value)
+{
+	const size_t size = buffer->size;
+	buffer->size = pos;
+	savegame_write_u32(buffer, value);
+	buffer->size = size;
+}
+
+static void savegame_write_level(game_t* game, savegame_buffer_t* buffer)
+{
+	savegame_write_string(buffer, game->level->map_path);
+}
+
+static void savegame_write_actor(level_t* level, actor_t* actor, savegame_buffer_t* buffer)
+{
+	de_vec3_t position, velocity;
+	de_node_get_global_position(actor->pivot, &position);
+	de_body_get_velocity(actor->body, &velocity);
+	savegame_write_u32(buffer, (uint32_t)actor->type);
+	savegame_write_u32(buffer, actor == level->player);
+	savegame_write_vec3(buffer, &position);
+	savegame_write_vec3(buffer, &velocity);
+	savegame_write_f32(buffer, actor->health);
+	savegame_write_f32(buffer, actor->move_speed);
+	switch (actor->type) {
+		case ACTOR_TYPE_PLAYER: {
+			player_t* player = actor_to_player(actor);
+			savegame_write_f32(buffer, player->pitch);
+			savegame_write_f32(buffer, player->desired_pitch);
+			savegame_write_f32(buffer, player->yaw);
+			savegame_write_f32(buffer, player->desired_yaw);
+			savegame_write_u32(buffer, player->is_crouch);
+			savegame_write_u32(buffer, (uint32_t)player->current_weapon);
+			savegame_write_u32(buffer, (uint32_t)player->weapons.size);
+			for (size_t i = 0; i < player->weapons.size; ++i) {
+				savegame_write_u32(buffer, (uint32_t)player->weapons.data[i]->type);
+				savegame_write_u32(buffer, player->weapons.data[i]->ammo);
+			}
+			break;
+		}
+		case ACTOR_TYPE_BOT:
+			savegame_write_u32(buffer, (uint32_t)actor_to_bot(actor)->type);
+			break;
+		default:
+			break;
+	}
+}
+
+static void savegame_write_actors(level_t* level, savegame_buffer_t* buffer)
+{
+	uint32_t count = 0;
+	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+		++count;
+	}
+	savegame_write_u32(buffer, count);
+	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+		savegame_write_actor(level, actor, buffer);
+	}
+}
+
+static void savegame_write_items(level_t* level, savegame_buffer_t* buffer)
+{
+	savegame_write_u32(buffer, (uint32_t)level->items.size);
+	for (size_t i = 0; i < level->items.size; ++i) {
+		item_t* item = level->items.data[i];
+		de_vec3_t position;
+		de_node_get_global_position(item->model, &position);
+		savegame_write_u32(buffer, (uint32_t)item->type);
+		savegame_write_vec3(buffer, &position);
+		savegame_write_f32(buffer, item_get_time_until_reactivation(item));
+	}
+}
+
+static void savegame_write_projectiles(level_t* level, savegame_buffer_t* buffer)
+{
+	uint32_t count = 0;
+	for (projectile_t* p = level->projectiles.head; p; p = p->next) {
+		++count;
+	}
+	savegame_write_u32(buffer, count);
+	for (projectile_t* p = level->projectiles.head; p; p = p->next) {
+		de_vec3_t position;
+		de_node_get_global_position(p->model, &position);
+		savegame_write_u32(buffer, (uint32_t)p->type);
+		savegame_write_vec3(buffer, &position);
+		savegame_write_vec3(buffer, &p->direction);
+		savegame_write_f32(buffer, projectile_get_lifetime(p));
+	}
+}
+
+static void savegame_write_rng(savegame_buffer_t* buffer, const rng_t* rng)
+{
+	for (size_t i = 0; i < DE_ARRAY_SIZE(rng->s); ++i) {
+		savegame_write_u32(buffer, rng->s[i]);
+	}
+}
+
+static void savegame_read_rng(savegame_buffer_t* buffer, rng_t* rng)
+{
+	for (size_t i = 0; i < DE_ARRAY_SIZE(rng->s); ++i) {
+		rng->s[i] = savegame_read_u32(buffer);
+	}
+}
+
+static void savegame_write_random(const rng_streams_t* random, savegame_buffer_t* buffer)
+{
+	savegame_write_u32(buffer, random->seed);
+	savegame_write_u32(buffer, RNG_STREAM_COUNT);
+	for (int i = 0; i < RNG_STREAM_COUNT; ++i) {
+		savegame_write_rng(buffer, &random->streams[i]);
+	}
+}
+
+static void savegame_read_random(rng_streams_t* random, uint32_t version, savegame_buffer_t* buffer)
+{
+	rng_streams_reseed(random, savegame_read_u32(buffer));
+	/* streams that are missing in save just start over from seed */
+	const uint32_t stream_count = savegame_read_u32(buffer);
+	for (uint32_t i = 0; i < stream_count && !buffer->read_error; ++i) {
+		rng_t rng;
+		savegame_read_rng(buffer, &rng);
+		if (i < RNG_STREAM_COUNT) {
+			random->streams[i] = rng;
+		}
+	}
+	if (version < SAVEGAME_NO_THREAD_STREAMS_VERSION) {
+		/* per-worker streams are gone, skip them */
+		const uint32_t thread_count = savegame_read_u32(buffer);
+		for (uint32_t i = 0; i < thread_count && !buffer->read_error; ++i) {
+			rng_t rng;
+			savegame_read_rng(buffer, &rng);
+		}
+	}
+}
+
+void savegame_write(game_t* game, savegame_buffer_t* buffer)
+{
+	level_t* level = game->level;
+	buffer->size = 0;
+
+	savegame_write_u32(buffer, SAVEGAME_MAGIC);
+	savegame_write_u32(buffer, SAVEGAME_VERSION);
+	savegame_write_u32(buffer, SAVEGAME_SECTION_COUNT);
+	const size_t table_pos = buffer->size;
+	for (int i = 0; i < SAVEGAME_SECTION_COUNT; ++i) {
+		savegame_write_u32(buffer, (uint32_t)i);
+		savegame_write_u32(buffer, 0);
+		savegame_write_u32(buffer, 0);
+	}
+
+	for (int i = 0; i < SAVEGAME_SECTION_COUNT; ++i) {
+		const size_t begin = buffer->size;
+		switch (i) {
+			case SAVEGAME_SECTION_LEVEL:
+				savegame_write_level(game, buffer);
+				break;
+			case SAVEGAME_SECTION_ACTORS:
+				savegame_write_actors(level, buffer);
+				break;
+			case SAVEGAME_SECTION_ITEMS:
+				savegame_write_items(level, buffer);
+				break;
+			case SAVEGAME_SECTION_PROJECTILES:
+				savegame_write_projectiles(level, buffer);
+				break;
+			case SAVEGAME_SECTION_RANDOM:
+				savegame_write_random(game->random, buffer);
+				break;
+		}
+		const size_t entry_pos = table_pos + (size_t)i * 3 * sizeof(uint32_t);
+		savegame_patch_u32(buffer, entry_pos + sizeof(uint32_t), (uint32_t)begin);
+		savegame_patch_u32(buffer, entry_pos + 2 * sizeof(uint32_t), (uint32_t)(buffer->size - begin));
+	}
+}
+
+static void savegame_dump_text(game_t* game, FILE* file)
+{
+	level_t* level = game->level;
+	fprintf(file, "version %u\n", SAVEGAME_VERSION);
+	fprintf(file, "level map=%s\n", level->map_path);
+	fprintf(file, "random seed=%u\n", (unsigned int)game->random->seed);
+	for (actor_t* actor = level->actors.head; actor; actor = actor->next) {
+		de_vec3_t position;
+		de_node_get_global_position(actor->pivot, &position);
+		fprintf(file, "actor type=%d player=%d position=(%f %f %f) health=%f move_speed=%f\n", (int)actor->type,
+			actor == level->player, position.x, position.y, position.z, actor->health, actor->move_speed);
+	}
+	for (size_t i = 0; i < level->items.size; ++i) {
+		item_t* item = level->items.data[i];
+		de_vec3_t position;
+		de_node_get_global_position(item->model, &position);
+		fprintf(file, "item type=%d position=(%f %f %f) reactivation=%f\n", (int)item->type,
+			position.x, position.y, position.z, item_get_time_until_reactivation(item));
+	}
+	for (projectile_t* p = level->projectiles.head; p; p = p->next) {
+		fprintf(file, "projectile type=%d lifetime=%f\n", (int)p->type, projectile_get_lifetime(p));
+	}
+}
+
+bool savegame_save(game_t* game, const char* path, const char* text_path)
+{
+	if (!game->level) {
+		return false;
+	}
+
+	savegame_buffer_t buffer;
+	savegame_buffer_init(&buffer);
+	savegame_write(game, &buffer);
+
+	bool result = false;
+	FILE* file = fopen(path, "wb");
+	if (file) {
+		result = fwrite(buffer.data, 1, buffer.size, file) == buffer.size;
+		fclose(file);
+	}
+	if (!result) {
+		de_log("savegame: unable to write %s", path);
+	}
+	savegame_buffer_free(&buffer);
+
+	if (text_path) {
+		FILE* text = fopen(text_path, "w");
+		if (text) {
+			savegame_dump_text(game, text);
+			fclose(text);
+		}
+	}
+
+	return result;
+}
+
+static void savegame_read_actor(level_t* level, savegame_buffer_t* buffer)
+{
+	const uint32_t type = savegame_read_u32(buffer);
+	const bool is_player = savegame_read_u32(buffer) != 0;
+	if (buffer->read_error || type >= ACTOR_TYPE_COUNT) {
+		buffer->read_error = true;
+		return;
+	}
+	actor_t* actor = actor_create(level, (actor_type_t)type);
+	if (is_player) {
+		level->player = actor;
+	}
+	de_vec3_t position, velocity;
+	savegame_read_vec3(buffer, &position);
+	savegame_read_vec3(buffer, &velocity);
+	actor_set_position(actor, &position);
+	de_body_set_velocity(actor->body, &velocity);
+	actor->health = savegame_read_f32(buffer);
+	actor->move_speed = savegame_read_f32(buffer);
+	switch (actor->type) {
+		case ACTOR_TYPE_PLAYER: {
+			player_t* player = actor_to_player(actor);
+			player->pitch = savegame_read_f32(buffer);
+			player->desired_pitch = savegame_read_f32(buffer);
+			player->yaw = savegame_read_f32(buffer);
+			player->desired_yaw = savegame_read_f32(buffer);
+			player->is_crouch = savegame_read_u32(buffer) != 0;
+			const uint32_t current_weapon = savegame_read_u32(buffer);
+			const uint32_t weapon_count = savegame_read_u32(buffer);
+			for (uint32_t i = 0; i < weapon_count; ++i) {
+				const uint32_t weapon_type = savegame_read_u32(buffer);
+				const uint32_t ammo = savegame_read_u32(buffer);
+				/* player always starts with same set of weapons, only ammo is restored */
+				if (i < player->weapons.size && player->weapons.data[i]->type == (weapon_type_t)weapon_type) {
+					player->weapons.data[i]->ammo = ammo;
+				}
+			}
+			if (current_weapon < player->weapons.size) {
+				player->current_weapon = (int)current_weapon;
+				for (size_t i = 0; i < player->weapons.size; ++i) {
+					weapon_set_visible(player->weapons.data[i], i == current_weapon);
+				}
+			}
+			break;
+		}
+		case ACTOR_TYPE_BOT:
+			actor_to_bot(actor)->type = (bot_type_t)savegame_read_u32(buffer);
+			break;
+		default:
+			break;
+	}
+}
+
+static void savegame_read_section(game_t* game, uint32_t version, savegame_section_type_t type, savegame_buffer_t* buffer)
+{
+	level_t* level = game->level;
+	switch (type) {
+		case SAVEGAME_SECTION_LEVEL:
+			/* handled by savegame_load, because level must exist before anything else */
+			break;
+		case SAVEGAME_SECTION_ACTORS: {
+			const uint32_t count = savegame_read_u32(buffer);
+			for (uint32_t i = 0; i < count && !buffer->read_error; ++i) {
+				savegame_read_actor(level, buffer);
+			}
+			break;
+		}
+		case SAVEGAME_SECTION_ITEMS: {
+			const uint32_t count = savegame_read_u32(buffer);
+			for (uint32_t i = 0; i < count && !buffer->read_error; ++i) {
+				const item_type_t item_type = (item_type_t)savegame_read_u32(buffer);
+				de_vec3_t position;
+				savegame_read_vec3(buffer, &position);
+				const float time_until_reactivation = savegame_read_f32(buffer);
+				if (buffer->read_error || !item_definition_from_item_type(item_type)) {
+					buffer->read_error = true;
+					break;
+				}
+				item_t* item = item_create(level, item_type);
+				item_set_position(item, &position);
+				item_set_time_until_reactivation(item, time_until_reactivation);
+			}
+			break;
+		}
+		case SAVEGAME_SECTION_PROJECTILES: {
+			const uint32_t count = savegame_read_u32(buffer);
+			for (uint32_t i = 0; i < count && !buffer->read_error; ++i) {
+				const uint32_t type = savegame_read_u32(buffer);
+				de_vec3_t position, direction;
+				savegame_read_vec3(buffer, &position);
+				savegame_read_vec3(buffer, &direction);
+				float lifetime;
+				if (version >= SAVEGAME_SECONDS_LIFETIME_VERSION) {
+					lifetime = savegame_read_f32(buffer);
+				} else {
+					/* older saves have ticks, tick rate they were made with is unknown */
+					lifetime = (float)((double)savegame_read_u32(buffer) * game->time.delta);
+				}
+				if (buffer->read_error || type >= PROJECTILE_TYPE_COUNT) {
+					buffer->read_error = true;
+					break;
+				}
+				projectile_t* p = projectile_create(level, (projectile_type_t)type, &position, &direction);
+				projectile_set_lifetime(p, lifetime);
+			}
+			break;
+		}
+		case SAVEGAME_SECTION_RANDOM:
+			savegame_read_random(game->random, version, buffer);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * @brief Reads one section from file into buffer, buffer memory is reused between sections.
+ */
+static bool savegame_read_file_section(FILE* file, const savegame_section_t* section, savegame_buffer_t* buffer)
+{
+	savegame_buffer_reserve(buffer, section->size);
+	buffer->size = section->size;
+	buffer->read_pos = 0;
+	buffer->read_error = false;
+	return fseek(file, (long)section->offset, SEEK_SET) == 0 && fread(buffer->data, 1, section->size, file) == section->size;
+}
+
+bool savegame_load(game_t* game, const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		de_log("savegame: unable to open %s", path);
+		return false;
+	}
+
+	/* header and section table */
+	savegame_section_t sections[SAVEGAME_MAX_SECTIONS];
+	savegame_buffer_t buffer;
+	savegame_buffer_init(&buffer);
+	savegame_buffer_reserve(&buffer, 3 * sizeof(uint32_t));
+	buffer.size = fread(buffer.data, 1, 3 * sizeof(uint32_t), file);
+	const uint32_t magic = savegame_read_u32(&buffer);
+	const uint32_t version = savegame_read_u32(&buffer);
+	const uint32_t section_count = savegame_read_u32(&buffer);
+	bool result = !buffer.read_error && magic == SAVEGAME_MAGIC &&
+		version >= SAVEGAME_MIN_VERSION && version <= SAVEGAME_VERSION &&
+		section_count > 0 && section_count <= SAVEGAME_MAX_SECTIONS;
+	long file_size = 0;
+	if (result) {
+		/* sizes in section table come from file, so they are checked against real size
+		 * of file before anything is allocated for them */
+		result = fseek(file, 0, SEEK_END) == 0 && (file_size = ftell(file)) >= 0 &&
+			fseek(file, (long)(3 * sizeof(uint32_t)), SEEK_SET) == 0;
+	}
+	if (result) {
+		buffer.read_pos = 0;
+		savegame_buffer_reserve(&buffer, section_count * 3 * sizeof(uint32_t));
+		buffer.size = fread(buffer.data, 1, section_count * 3 * sizeof(uint32_t), file);
+		for (uint32_t i = 0; i < section_count; ++i) {
+			sections[i].type = savegame_read_u32(&buffer);
+			sections[i].offset = savegame_read_u32(&buffer);
+			sections[i].size = savegame_read_u32(&buffer);
+			if ((uint64_t)sections[i].offset + sections[i].size > (uint64_t)file_size) {
+				buffer.read_error = true;
+			}
+		}
+		result = !buffer.read_error && sections[0].type == SAVEGAME_SECTION_LEVEL;
+	}
+	if (result) {
+		result = savegame_read_file_section(file, &sections[0], &buffer);
+	}
+	char map_path[LEVEL_MAP_PATH_MAX];
+	if (result) {
+		savegame_read_string(&buffer, map_path, sizeof(map_path));
+		result = !buffer.read_error;
+	}
+	if (!result) {
+		de_log("savegame: %s is not a valid save file", path);
+		savegame_buffer_free(&buffer);
+		fclose(file);
+		return false;
+	}
+
+	/* file looks fine, replace current level */
+	if (game->level) {
+		level_free(game->level);
+	}
+	game->level = level_create(game, map_path);
+	for (uint32_t i = 1; i < section_count && result; ++i) {
+		result = savegame_read_file_section(file, &sections[i], &buffer);
+		if (result) {
+			savegame_read_section(game, version, (savegame_section_type_t)sections[i].type, &buffer);
+			result = !buffer.read_error;
+		}
+	}
+	if (!result) {
+		de_log("savegame: %s is corrupted, level is loaded partially", path);
+	}
+
+	savegame_buffer_free(&buffer);
+	fclose(file);
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+/* Compact save file layout (little-endian, no padding):
+ *   header: magic, version, section count (uint32 each)
+ *   section table: type, offset from beginning of file, size (uint32 each)
+ *   sections: data of each section
+ * Only game-side state is stored, resources are re-instantiated by path on load,
+ * so files are small and load does not depend on engine object layout. */
+
+#define SAVEGAME_MAGIC 0x56534853u /* "SHSV" */
+#define SAVEGAME_VERSION 4u
+#define SAVEGAME_MIN_VERSION 1u /**< Oldest version that can be loaded, version 1 has no random section. */
+#define SAVEGAME_SECONDS_LIFETIME_VERSION 3u /**< Older versions store projectile lifetime in ticks. */
+#define SAVEGAME_NO_THREAD_STREAMS_VERSION 4u /**< Older versions store random streams of job threads. */
+#define SAVEGAME_MAX_SECTIONS 16
+
+typedef enum savegame_section_type_t {
+	SAVEGAME_SECTION_LEVEL, /**< Map path, must be first */
+	SAVEGAME_SECTION_ACTORS,
+	SAVEGAME_SECTION_ITEMS,
+	SAVEGAME_SECTION_PROJECTILES,
+	SAVEGAME_SECTION_RANDOM, /**< Seed and state of every stream of game randomness */
+	SAVEGAME_SECTION_COUNT,
+} savegame_section_type_t;
+
+typedef struct savegame_section_t {
+	uint32_t type;
+	uint32_t offset;
+	uint32_t size;
+} savegame_section_t;
+
+/**
+ * @brief Growing byte buffer. Used for whole save file when writing and for
+ * single section when reading.
+ */
+typedef struct savegame_buffer_t {
+	uint8_t* data;
+	size_t size;
+	size_t capacity;
+	size_t read_pos;
+	bool read_error; /**< Set when read went past end of buffer. */
+} savegame_buffer_t;
+
+void savegame_buffer_init(savegame_buffer_t* buffer);
+
+void savegame_buffer_free(savegame_buffer_t* buffer);
+
+/**
+ * @brief Reads whole file into empty buffer. Returns false if file is missing, empty or was read partially.
+ */
+bool savegame_buffer_read_file(const char* path, savegame_buffer_t* buffer);
+
+/* Little-endian primitives, also used by other binary formats of game. Reads past
+ * end of buffer return zeros and set read_error, so it is enough to check flag once
+ * after whole block is read. */
+void savegame_write_bytes(savegame_buffer_t* buffer, const void* data, size_t size);
+
+void savegame_write_u32(savegame_buffer_t* buffer, uint32_t value);
+
+void savegame_write_f32(savegame_buffer_t* buffer, float value);
+
+void savegame_write_vec3(savegame_buffer_t* buffer, const de_vec3_t* v);
+
+void savegame_write_string(savegame_buffer_t* buffer, const char* str);
+
+bool savegame_read_bytes(savegame_buffer_t* buffer, void* data, size_t size);
+
+uint32_t savegame_read_u32(savegame_buffer_t* buffer);
+
+float savegame_read_f32(savegame_buffer_t* buffer);
+
+void savegame_read_vec3(savegame_buffer_t* buffer, de_vec3_t* v);
+
+void savegame_read_string(savegame_buffer_t* buffer, char* str, size_t max_len);
+
+/**
+ * @brief Serializes state of level into memory, buffer is cleared first.
+ */
+void savegame_write(game_t* game, savegame_buffer_t* buffer);
+
+/**
+ * @brief Writes serialized state to file in one call. Human-readable dump of same
+ * state is written to text_path, pass NULL to skip it (it is for debugging only).
+ */
+bool savegame_save(game_t* game, const char* path, const char* text_path);
+
+/**
+ * @brief Reads file section by section and rebuilds level from it. Current level
+ * is replaced only if header of file is valid.
+ */
+bool savegame_load(game_t* game, const char* path);
\ No newline at end of file
@@ -0,0 +1,96 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+sound_pool_t* sound_pool_create(de_sound_context_t* ctx, size_t voice_count)
+{
+	sound_pool_t* pool = DE_NEW(sound_pool_t);
+	if (voice_count > SOUND_POOL_MAX_VOICES) {
+		voice_count = SOUND_POOL_MAX_VOICES;
+	}
+	pool->voice_count = voice_count;
+	for (size_t i = 0; i < pool->voice_count; ++i) {
+		pool->voices[i].source = de_sound_source_create(ctx, DE_SOUND_SOURCE_TYPE_3D);
+	}
+	return pool;
+}
+
+void sound_pool_free(sound_pool_t* pool)
+{
+	for (size_t i = 0; i < pool->voice_count; ++i) {
+		de_sound_source_free(pool->voices[i].source);
+	}
+	de_free(pool);
+}
+
+void sound_pool_set_listener_position(sound_pool_t* pool, const de_vec3_t* position)
+{
+	pool->listener_position = *position;
+}
+
+/**
+ * @brief Returns true if voice a is less important than voice b.
+ */
+static bool sound_pool_is_less_important(sound_priority_t a_priority, float a_sqr_distance, sound_priority_t b_priority, float b_sqr_distance)
+{
+	if (a_priority != b_priority) {
+		return a_priority < b_priority;
+	}
+	return a_sqr_distance > b_sqr_distance;
+}
+
+bool sound_pool_play(sound_pool_t* pool, de_sound_buffer_t* buffer, const de_vec3_t* position, sound_priority_t priority)
+{
+	if (!pool->voice_count) {
+		return false;
+	}
+	const float sqr_distance = de_vec3_sqr_distance(position, &pool->listener_position);
+
+	/* free voice first, otherwise least important one */
+	sound_voice_t* voice = NULL;
+	sound_voice_t* victim = NULL;
+	for (size_t i = 0; i < pool->voice_count; ++i) {
+		sound_voice_t* v = pool->voices + i;
+		if (!de_sound_source_is_playing(v->source)) {
+			voice = v;
+			break;
+		}
+		if (!victim || sound_pool_is_less_important(v->priority, v->sqr_distance, victim->priority, victim->sqr_distance)) {
+			victim = v;
+		}
+	}
+	if (!voice) {
+		if (!sound_pool_is_less_important(victim->priority, victim->sqr_distance, priority, sqr_distance)) {
+			++pool->dropped_count;
+			return false;
+		}
+		de_sound_source_stop(victim->source);
+		++pool->stolen_count;
+		voice = victim;
+	}
+
+	voice->priority = priority;
+	voice->sqr_distance = sqr_distance;
+	de_sound_source_set_buffer(voice->source, buffer);
+	de_sound_source_set_position(voice->source, position);
+	de_sound_source_play(voice->source);
+	return true;
+}
\ No newline at end of file
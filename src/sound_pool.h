@@ -0,0 +1,64 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+#define SOUND_POOL_MAX_VOICES 32
+
+typedef enum sound_priority_t {
+	SOUND_PRIORITY_LOW, /**< Footsteps and other ambient one-shots, first to be stolen. */
+	SOUND_PRIORITY_NORMAL,
+	SOUND_PRIORITY_HIGH, /**< Shots and hits. */
+} sound_priority_t;
+
+typedef struct sound_voice_t {
+	de_sound_source_t* source;
+	sound_priority_t priority;
+	float sqr_distance; /**< Squared distance to listener at the moment voice was started. */
+} sound_voice_t;
+
+/**
+ * @brief Fixed set of preallocated 3D sources for one-shot sounds. Sources are
+ * never created or freed while playing, and amount of concurrent voices is
+ * capped - when every voice is busy, the least important one (lowest priority,
+ * then farthest from listener) is stopped and reused, or new sound is dropped
+ * if it is even less important.
+ */
+struct sound_pool_t {
+	sound_voice_t voices[SOUND_POOL_MAX_VOICES];
+	size_t voice_count;
+	de_vec3_t listener_position;
+	size_t stolen_count; /**< Voices stopped to play more important sound. */
+	size_t dropped_count; /**< Sounds not played because every voice was more important. */
+};
+
+sound_pool_t* sound_pool_create(de_sound_context_t* ctx, size_t voice_count);
+
+void sound_pool_free(sound_pool_t* pool);
+
+/**
+ * @brief Listener position is used to find farthest voice when stealing.
+ */
+void sound_pool_set_listener_position(sound_pool_t* pool, const de_vec3_t* position);
+
+/**
+ * @brief Plays buffer once at given position. Returns false if sound was dropped.
+ */
+bool sound_pool_play(sound_pool_t* pool, de_sound_buffer_t* buffer, const de_vec3_t* position, sound_priority_t priority);
\ No newline at end of file
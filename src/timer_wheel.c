@@ -0,0 +1,128 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+void timer_wheel_init(timer_wheel_t* wheel)
+{
+	memset(wheel, 0, sizeof(*wheel));
+}
+
+static void timer_wheel_insert(timer_wheel_t* wheel, game_timer_t* timer)
+{
+	uint64_t delta = timer->expire_tick - wheel->now;
+	uint64_t expire = timer->expire_tick;
+	const uint64_t max_delta = ((uint64_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+	if (delta > max_delta) {
+		/* parked in farthest slot, will be cascaded down again when reached */
+		delta = max_delta;
+		expire = wheel->now + max_delta;
+	}
+	int level = 0;
+	while (level < TIMER_WHEEL_LEVELS - 1 && delta >= ((uint64_t)1 << (TIMER_WHEEL_BITS * (level + 1)))) {
+		++level;
+	}
+	timer_wheel_slot_t* slot = &wheel->levels[level][(expire >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK];
+	timer->slot = slot;
+	DE_LINKED_LIST_APPEND(slot->timers, timer);
+}
+
+static void timer_wheel_unlink(game_timer_t* timer)
+{
+	DE_LINKED_LIST_REMOVE(timer->slot->timers, timer);
+	timer->slot = NULL;
+}
+
+void timer_wheel_schedule(timer_wheel_t* wheel, game_timer_t* timer, uint64_t delay, game_timer_func_t func, void* user_data)
+{
+	if (timer->slot) {
+		timer_wheel_cancel(wheel, timer);
+	}
+	timer->expire_tick = wheel->now + (delay ? delay : 1);
+	timer->func = func;
+	timer->user_data = user_data;
+	timer_wheel_insert(wheel, timer);
+	++wheel->scheduled_count;
+}
+
+void timer_wheel_cancel(timer_wheel_t* wheel, game_timer_t* timer)
+{
+	if (timer->slot) {
+		timer_wheel_unlink(timer);
+		--wheel->scheduled_count;
+	}
+}
+
+/**
+ * @brief Moves every timer of slot to lower levels.
+ */
+static void timer_wheel_cascade(timer_wheel_t* wheel, timer_wheel_slot_t* slot)
+{
+	while (slot->timers.head) {
+		game_timer_t* timer = slot->timers.head;
+		timer_wheel_unlink(timer);
+		timer_wheel_insert(wheel, timer);
+	}
+}
+
+void timer_wheel_tick(timer_wheel_t* wheel)
+{
+	++wheel->now;
+	for (int level = 1; level < TIMER_WHEEL_LEVELS; ++level) {
+		/* lower level wrapped around - its next round is in current slot of this level */
+		if ((wheel->now >> (TIMER_WHEEL_BITS * (level - 1))) & TIMER_WHEEL_MASK) {
+			break;
+		}
+		timer_wheel_cascade(wheel, &wheel->levels[level][(wheel->now >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK]);
+	}
+
+	timer_wheel_slot_t* slot = &wheel->levels[0][wheel->now & TIMER_WHEEL_MASK];
+	while (slot->timers.head) {
+		game_timer_t* timer = slot->timers.head;
+		timer_wheel_unlink(timer);
+		if (timer->expire_tick > wheel->now) {
+			/* clamped timer of far future, not due yet */
+			timer_wheel_insert(wheel, timer);
+			continue;
+		}
+		--wheel->scheduled_count;
+		++wheel->fired_count;
+		timer->func(timer, timer->user_data);
+	}
+}
+
+bool game_timer_is_scheduled(const game_timer_t* timer)
+{
+	return timer->slot != NULL;
+}
+
+uint64_t timer_wheel_get_remaining(const timer_wheel_t* wheel, const game_timer_t* timer)
+{
+	return timer->slot ? timer->expire_tick - wheel->now : 0;
+}
+
+uint64_t timer_wheel_ticks_from_seconds(double seconds, double tick_duration)
+{
+	if (seconds <= 0.0) {
+		return 0;
+	}
+	/* small epsilon, so 30 s at 60 Hz is exactly 1800 ticks despite rounding of 1/60 */
+	return (uint64_t)ceil(seconds / tick_duration - 1e-6);
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/* Copyright (c) 2017-2019 Dmitry Stepanov a.k.a mr.DIMAS
+*
+* Permission is hereby granted, free of charge, to any person obtaining
+* a copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to
+* permit persons to whom the Software is furnished to do so, subject to
+* the following conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+* LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+* OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+* WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS 4 /**< 2^24 ticks ahead, ~77 hours at 60 Hz. */
+
+typedef struct game_timer_t game_timer_t;
+
+typedef void(*game_timer_func_t)(game_timer_t* timer, void* user_data);
+
+typedef struct timer_wheel_slot_t {
+	DE_LINKED_LIST_DECLARE(struct game_timer_t, timers);
+} timer_wheel_slot_t;
+
+/**
+ * @brief Delayed event, embedded in object that owns it, so scheduling does not
+ * allocate.
+ */
+struct game_timer_t {
+	uint64_t expire_tick;
+	game_timer_func_t func;
+	void* user_data;
+	timer_wheel_slot_t* slot; /**< NULL if timer is not scheduled. */
+	DE_LINKED_LIST_ITEM(struct game_timer_t);
+};
+
+/**
+ * @brief Hierarchical timer wheel driven by fixed simulation ticks. Each level has
+ * 64 slots, level N slot covers 64^N ticks. Timers of far future are moved to
+ * lower levels when wheel reaches their slot, so schedule and cancel are O(1)
+ * and tick costs nothing when no timer is due, no matter how many are pending.
+ */
+typedef struct timer_wheel_t {
+	timer_wheel_slot_t levels[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+	uint64_t now; /**< Amount of ticks passed. */
+	size_t scheduled_count;
+	size_t fired_count;
+} timer_wheel_t;
+
+void timer_wheel_init(timer_wheel_t* wheel);
+
+/**
+ * @brief Schedules timer to fire after given amount of ticks (at least one). Timer
+ * that is already scheduled is rescheduled.
+ */
+void timer_wheel_schedule(timer_wheel_t* wheel, game_timer_t* timer, uint64_t delay, game_timer_func_t func, void* user_data);
+
+void timer_wheel_cancel(timer_wheel_t* wheel, game_timer_t* timer);
+
+/**
+ * @brief Advances wheel by one tick and fires every timer that is due. Timers are
+ * unscheduled before their function is called, so it can schedule them again.
+ */
+void timer_wheel_tick(timer_wheel_t* wheel);
+
+bool game_timer_is_scheduled(const game_timer_t* timer);
+
+/**
+ * @brief Returns amount of ticks until timer fires, 0 if it is not scheduled.
+ */
+uint64_t timer_wheel_get_remaining(const timer_wheel_t* wheel, const game_timer_t* timer);
+
+/**
+ * @brief Converts seconds to whole ticks of given length, rounding up so event
+ * never fires early.
+ */
+uint64_t timer_wheel_ticks_from_seconds(double seconds, double tick_duration);
\ No newline at end of file
@@ -19,6 +19,14 @@
 * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
 * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+static void weapon_request_shot_sound(weapon_t* wpn)
+{
+	wpn->shot_sound = asset_registry_get(&wpn->level->assets, ASSET_SOUND_M4_SHOT);
+	if (wpn->shot_sound) {
+		de_resource_add_ref(wpn->shot_sound);
+	}
+}
+
 weapon_t* weapon_create(level_t* level, weapon_type_t type)
 {
 	weapon_t* wpn = DE_NEW(weapon_t);
@@ -26,13 +34,13 @@ weapon_t* weapon_create(level_t* level, weapon_type_t type)
 	wpn->level = level;
 	wpn->ammo = 100;
 
-	de_path_t path;
+	asset_id_t model_id;
 	switch (type) {
 		case WEAPON_TYPE_AK47:
-			de_path_from_cstr_as_view(&path, "data/models/ak47/ak47.fbx");
+			model_id = ASSET_MODEL_AK47;
 			break;
 		case WEAPON_TYPE_M4:
-			de_path_from_cstr_as_view(&path, "data/models/m4/m4.fbx");
+			model_id = ASSET_MODEL_M4;
 			break;
 		default:
 			de_log("invalid weapon type");
@@ -40,8 +48,9 @@ weapon_t* weapon_create(level_t* level, weapon_type_t type)
 			return NULL;
 	}
 
-	de_resource_t* model_resource = de_core_request_resource(level->game->core, DE_RESOURCE_TYPE_MODEL, &path);
-	wpn->model = de_model_instantiate(de_resource_to_model(model_resource), level->scene);
+	wpn->model = de_model_instantiate(asset_registry_get_model(&level->assets, model_id), level->scene);
+
+	weapon_request_shot_sound(wpn);
 
 	wpn->shot_light = de_node_create(level->scene, DE_NODE_TYPE_LIGHT);
 	de_light_t* shot_light = de_node_to_light(wpn->shot_light);
@@ -61,15 +70,20 @@ void weapon_set_visible(weapon_t* wpn, bool state)
 
 void weapon_free(weapon_t* wpn)
 {
+	if (wpn->shot_sound) {
+		de_resource_release(wpn->shot_sound);
+	}
 	de_node_free(wpn->model);
 	de_free(wpn);
 }
 
 void weapon_update(weapon_t* wpn)
 {
-	wpn->offset.x += (wpn->dest_offset.x - wpn->offset.x) * 0.1f;
-	wpn->offset.y += (wpn->dest_offset.y - wpn->offset.y) * 0.1f;
-	wpn->offset.z += (wpn->dest_offset.z - wpn->offset.z) * 0.1f;
+	const game_t* game = wpn->level->game;
+	const float offset_smoothing = game_get_smoothing(game, 0.1f);
+	wpn->offset.x += (wpn->dest_offset.x - wpn->offset.x) * offset_smoothing;
+	wpn->offset.y += (wpn->dest_offset.y - wpn->offset.y) * offset_smoothing;
+	wpn->offset.z += (wpn->dest_offset.z - wpn->offset.z) * offset_smoothing;
 
 	de_node_set_local_position(wpn->model, &wpn->offset);
 
@@ -77,21 +91,16 @@ void weapon_update(weapon_t* wpn)
 	de_light_set_radius(shot_light, wpn->shot_light_radius);
 	de_light_set_color(shot_light, &(de_color_t){.r = 255, .g = 207, .b = 168});
 
-	wpn->shot_light_radius -= 0.45f;
+	wpn->shot_light_radius -= 0.45f * game_get_tick_scale(game);
 	if (wpn->shot_light_radius < 0.0f) {
 		wpn->shot_light_radius = 0.0f;
 	}
 }
 
-bool weapon_visit(de_object_visitor_t* visitor, weapon_t* wpn)
+float weapon_get_damage(const weapon_t* wpn)
 {
-	bool result = true;
-	result &= de_object_visitor_visit_int32(visitor, "Type", (int32_t*)&wpn->type);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "Level", &wpn->level, level_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "Model", &wpn->model, de_node_visit);
-	result &= DE_OBJECT_VISITOR_VISIT_POINTER(visitor, "ShotLight", &wpn->shot_light, de_node_visit);
-	result &= de_object_visitor_visit_uint32(visitor, "Ammo", &wpn->ammo);
-	return result;
+	const item_definition_t* definition = item_definition_from_item_type(wpn->type == WEAPON_TYPE_AK47 ? ITEM_TYPE_AK47 : ITEM_TYPE_M4);
+	return definition->damage;
 }
 
 void weapon_shoot(weapon_t* wpn)
@@ -103,24 +112,24 @@ void weapon_shoot(weapon_t* wpn)
 		de_ray_t ray;
 		de_node_get_global_position(wpn->model, &ray.origin);
 		de_node_get_look_vector(wpn->model, &ray.dir);
-		de_vec3_scale(&ray.dir, &ray.dir, 30.0f);
-
-		de_path_t path;
-		de_path_from_cstr_as_view(&path, "data/sounds/m4_shot.wav");
-		de_resource_t* res = de_core_request_resource(game->core, DE_RESOURCE_TYPE_SOUND_BUFFER, &path);
-		if (res) {
-			de_sound_context_t* context = de_core_get_sound_context(game->core);
-			de_sound_source_t* shot_sound = de_sound_source_create(context, DE_SOUND_SOURCE_TYPE_3D);
-			de_sound_source_set_buffer(shot_sound, de_resource_to_sound_buffer(res));
-			de_sound_source_set_play_once(shot_sound, true);
-			de_sound_source_play(shot_sound);
-			de_sound_source_set_position(shot_sound, &ray.origin);
-		}
-				/*
-		if (de_ray_cast(wpn->level->scene, &ray,
-			DE_RAY_CAST_FLAGS_IGNORE_BODY_IN_RAY | DE_RAY_CAST_FLAGS_SORT_RESULTS, &wpn->ray_cast_list)) {
+		de_vec3_scale(&ray.dir, &ray.dir, WEAPON_RANGE);
 
-		}*/
+#ifndef SHOOTER_DEDICATED_SERVER
+		if (wpn->shot_sound && game->sound_pool) {
+			sound_pool_play(game->sound_pool, de_resource_to_sound_buffer(wpn->shot_sound), &ray.origin, SOUND_PRIORITY_HIGH);
+		}
+#endif
+		/* resolved in batch with other shots of this tick */
+		if (wpn->owner && wpn->owner->type == ACTOR_TYPE_PLAYER && actor_to_player(wpn->owner)->aim.valid) {
+			/* player shoots where laser sight points, so its world hit is reused */
+			const player_aim_t* aim = &actor_to_player(wpn->owner)->aim;
+			de_ray_t aim_ray = aim->ray;
+			de_vec3_scale(&aim_ray.dir, &aim->look, WEAPON_RANGE);
+			hitscan_queue_shot_with_world_hit(&wpn->level->hitscan, &aim_ray, weapon_get_damage(wpn), wpn->owner,
+				aim->world_hit_distance, &aim->world_hit_position);
+		} else {
+			hitscan_queue_shot(&wpn->level->hitscan, &ray, weapon_get_damage(wpn), wpn->owner);
+		}
 
 		wpn->shot_light_radius = 4.0f;
 
@@ -19,6 +19,8 @@
 * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
 * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#define WEAPON_RANGE 30.0f
+
 typedef enum weapon_type_t {
 	WEAPON_TYPE_AK47,
 	WEAPON_TYPE_M4,
@@ -29,13 +31,14 @@ struct weapon_t {
 	weapon_type_t type;
 	de_node_t* model;
 	level_t* level;	 
+	actor_t* owner; /**< Excluded from hit test of own shots. */
 	de_node_t* shot_light;
+	de_resource_t* shot_sound; /**< Requested once on creation instead of on every shot. */
 	float shot_light_radius;
 	de_vec3_t offset;
 	de_vec3_t dest_offset;
 	double last_shot_time;
 	uint32_t ammo;
-	de_ray_cast_result_array_t ray_cast_list;
 };
 
 weapon_t* weapon_create(level_t* level, weapon_type_t type);
@@ -44,8 +47,11 @@ void weapon_free(weapon_t* wpn);
 
 void weapon_update(weapon_t* wpn);
 
-bool weapon_visit(de_object_visitor_t* visitor, weapon_t* wpn);
-
 void weapon_set_visible(weapon_t* wpn, bool state);
 
-void weapon_shoot(weapon_t* wpn);
\ No newline at end of file
+void weapon_shoot(weapon_t* wpn);
+
+/**
+ * @brief Damage of one shot, taken from definition of item of same type.
+ */
+float weapon_get_damage(const weapon_t* wpn);
\ No newline at end of file